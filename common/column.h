@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/*
+This header file defines Column, one column of a columnar table. A
+column either owns its values (a std::vector) or views values that live
+elsewhere, typically a memory-mapped cache file, without copying them.
+
+Reading works the same either way. The first change to a viewed column
+(push_back, append, reserve, ...) copies the values into owned storage,
+so a table reloaded from a read-only mapping can still grow. Whoever
+creates a view keeps the viewed memory alive for as long as the column
+(or any copy of it) may read it.
+*/
+
+template <typename T>
+class Column {
+private:
+    std::vector<T> owned;        // Values when the column owns them
+    const T* view = nullptr;     // Values when viewing memory owned elsewhere
+    size_t viewSize = 0;         // Number of viewed values
+
+    // Copies viewed values into owned storage before the first change
+    void detach() {
+        if (!view) return;
+        owned.assign(view, view + viewSize);
+        view = nullptr;
+        viewSize = 0;
+    }
+
+public:
+    Column() = default;
+
+    // A column that reads count values at data without owning them
+    static Column viewOf(const T* data, size_t count) {
+        Column column;
+        column.view = data;
+        column.viewSize = count;
+        return column;
+    }
+
+    bool isView() const { return view != nullptr; }
+
+    size_t size() const { return view ? viewSize : owned.size(); }
+    bool empty() const { return size() == 0; }
+    const T* data() const { return view ? view : owned.data(); }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size(); }
+    const T& operator[](size_t i) const { return data()[i]; }
+    const T& back() const { return data()[size() - 1]; }
+
+    void push_back(const T& value) {
+        detach();
+        owned.push_back(value);
+    }
+
+    // Appends the values in [first, last)
+    template <typename It>
+    void append(It first, It last) {
+        detach();
+        owned.insert(owned.end(), first, last);
+    }
+
+    void reserve(size_t count) {
+        detach();
+        owned.reserve(count);
+    }
+
+    void clear() {
+        view = nullptr;
+        viewSize = 0;
+        owned.clear();
+    }
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*
+This header file defines the helpers the batch modules share for using
+the machine: picking a thread count, running work over equal slices of
+a range on that many threads, and detecting which SIMD instructions the
+CPU and OS support so a module can choose its kernels once at startup.
+*/
+
+// ---------------------------------------------------------------- Threads
+
+// Threads to use when the caller asked for threads: 0 or less means every hardware thread
+inline int hardwareThreads(int threads) {
+    if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+    return threads > 0 ? threads : 1;
+}
+
+// Thread count for rows of work: inputs under minRowsPerThread rows per thread stay on one
+inline int sliceCount(size_t rows, int threads, size_t minRowsPerThread) {
+    threads = hardwareThreads(threads);
+    if (rows < (size_t)threads * minRowsPerThread) threads = 1;
+    return threads;
+}
+
+// Runs body(slice, begin, end) over threads equal slices of [0, rows); slice 0 on this thread
+template <typename Body>
+void runSlices(size_t rows, int threads, Body body) {
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; i++) {
+        workers.emplace_back([&, i]() { body(i, rows * i / threads, rows * (i + 1) / threads); });
+    }
+    body(0, 0, rows / threads);
+    for (std::thread& t : workers) t.join();
+}
+
+// ---------------------------------------------------------------- SIMD support
+
+// Instruction sets usable on this machine; always false off x86-64
+struct CpuFeatures {
+    bool sse42 = false;
+    bool avx2 = false;     // Also implies the OS saves YMM registers
+    bool fma = false;
+    bool avx512f = false;  // Also implies the OS saves ZMM registers
+};
+
+inline CpuFeatures detectCpuFeatures() {
+    CpuFeatures f;
+#if (defined(__x86_64__) || defined(_M_X64)) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    f.sse42 = (info[2] & (1 << 20)) != 0;
+    f.fma = (xcr0 & 6) == 6 && (info[2] & (1 << 12)) != 0;
+    __cpuidex(info, 7, 0);
+    f.avx2 = (xcr0 & 6) == 6 && (info[1] & (1 << 5)) != 0;
+    f.avx512f = f.avx2 && (xcr0 & 0xE6) == 0xE6 && (info[1] & (1 << 16)) != 0;
+#elif defined(__x86_64__)
+    f.sse42 = __builtin_cpu_supports("sse4.2");
+    f.avx2 = __builtin_cpu_supports("avx2");
+    f.fma = __builtin_cpu_supports("fma");
+    f.avx512f = __builtin_cpu_supports("avx512f");
+#endif
+    return f;
+}
+
+// Detected once per process
+inline const CpuFeatures& cpuFeatures() {
+    static const CpuFeatures features = detectCpuFeatures();
+    return features;
+}
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/*
+This header file defines CsvSchema, a compile-time description of how a
+row struct maps to the columns of a CSV file. A schema lists one
+CsvField per column in file order, naming the struct member, the header
+name and optionally a codec (how the text converts to the member):
+
+    struct TaskRow { std::string_view name; long long duration; };
+    const CsvSchema taskSchema(CsvField<&TaskRow::name>("name"),
+                               CsvField<&TaskRow::duration>("duration"));
+
+The compiler then generates a parser and a writer specialized for that
+row: every field is parsed in sequence with no loop or switch over
+columns, numbers go through from_chars/to_chars, and nothing allocates
+unless the row itself holds a std::string. Parse failures name the
+column that failed, and parseCsvText() adds line numbers.
+
+Codecs are plain structs with two static functions:
+    bool parse(const char* begin, const char* end, T& value);
+    char* write(char* out, char* limit, const T& value); // nullptr if out of room
+CsvValue (numbers and text) is the default; CsvYesNo maps "Yes"/"No" to
+bool or 0/1; CsvCommaText is text that may itself contain commas, which
+is only allowed in the first column (the other columns are then split
+off from the right).
+*/
+
+// ---------------------------------------------------------------- Codecs
+
+// Numbers via from_chars / to_chars; std::string and std::string_view are copied as-is.
+// A std::string_view points into the parsed line, so it is only valid as long as the line is.
+struct CsvValue {
+    template <typename T>
+    static bool parse(const char* begin, const char* end, T& value) {
+        if constexpr (std::is_same_v<T, std::string>) {
+            value.assign(begin, end); // Reuses the string's capacity when the row is reused
+            return true;
+        } else if constexpr (std::is_same_v<T, std::string_view>) {
+            value = std::string_view(begin, (size_t)(end - begin));
+            return true;
+        } else if constexpr (std::is_same_v<T, bool>) {
+            if (end - begin != 1 || (*begin != '0' && *begin != '1')) return false;
+            value = *begin == '1';
+            return true;
+        } else {
+            auto result = std::from_chars(begin, end, value);
+            return result.ec == std::errc() && result.ptr == end;
+        }
+    }
+
+    template <typename T>
+    static char* write(char* out, char* limit, const T& value) {
+        if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>) {
+            if (value.size() > (size_t)(limit - out)) return nullptr;
+            std::memcpy(out, value.data(), value.size());
+            return out + value.size();
+        } else if constexpr (std::is_same_v<T, bool>) {
+            if (out == limit) return nullptr;
+            *out = value ? '1' : '0';
+            return out + 1;
+        } else {
+            auto result = std::to_chars(out, limit, value);
+            return result.ec == std::errc() ? result.ptr : nullptr;
+        }
+    }
+};
+
+// "Yes" / "No" into a bool or an integer member (1 / 0)
+struct CsvYesNo {
+    template <typename T>
+    static bool parse(const char* begin, const char* end, T& value) {
+        size_t n = (size_t)(end - begin);
+        if (n == 3 && std::memcmp(begin, "Yes", 3) == 0) value = T(1);
+        else if (n == 2 && std::memcmp(begin, "No", 2) == 0) value = T(0);
+        else return false;
+        return true;
+    }
+
+    template <typename T>
+    static char* write(char* out, char* limit, const T& value) {
+        std::string_view text = value ? "Yes" : "No";
+        if (text.size() > (size_t)(limit - out)) return nullptr;
+        std::memcpy(out, text.data(), text.size());
+        return out + text.size();
+    }
+};
+
+// Text that may contain commas (free-form names); first column only
+struct CsvCommaText : CsvValue {
+    static constexpr bool TakesCommas = true;
+};
+
+// ---------------------------------------------------------------- Schema
+
+template <typename T>
+struct CsvMemberTraits;
+
+template <typename R, typename T>
+struct CsvMemberTraits<T R::*> {
+    using Row = R;
+    using Type = T;
+};
+
+// One column: the struct member it fills, its header name and its codec
+template <auto Member, typename Codec = CsvValue>
+struct CsvField {
+    using Row = typename CsvMemberTraits<decltype(Member)>::Row;
+    using Type = typename CsvMemberTraits<decltype(Member)>::Type;
+    using Format = Codec;
+    static constexpr auto member = Member;
+
+    const char* name; // Header name
+
+    constexpr explicit CsvField(const char* name) : name(name) {}
+};
+
+template <typename Codec, typename = void>
+struct CsvTakesCommas : std::false_type {};
+
+template <typename Codec>
+struct CsvTakesCommas<Codec, std::void_t<decltype(Codec::TakesCommas)>> : std::bool_constant<Codec::TakesCommas> {};
+
+template <typename... Fields>
+class CsvSchema {
+public:
+    using Row = typename std::tuple_element_t<0, std::tuple<Fields...>>::Row;
+    static constexpr size_t FieldCount = sizeof...(Fields);
+
+private:
+    using FieldTuple = std::tuple<Fields...>;
+    template <size_t I>
+    using FieldAt = std::tuple_element_t<I, FieldTuple>;
+
+    static_assert((std::is_same_v<typename Fields::Row, Row> && ...), "Every field must be a member of the same row type");
+    static_assert(!(CsvTakesCommas<typename Fields::Format>::value + ... + 0) ||
+                      (CsvTakesCommas<typename FieldAt<0>::Format>::value &&
+                       (CsvTakesCommas<typename Fields::Format>::value + ... + 0) == 1),
+                  "Only the first column may contain commas");
+
+    FieldTuple fields;
+
+    // The first field ends at the (FieldCount - 1)th comma from the right when it may contain commas
+    static const char* firstFieldEnd(const char* begin, const char* end) {
+        if constexpr (CsvTakesCommas<typename FieldAt<0>::Format>::value) {
+            const char* p = end;
+            for (size_t commas = 1; commas < FieldCount; commas++) {
+                while (p > begin && p[-1] != ',') p--;
+                if (p == begin) return nullptr;
+                p--;
+            }
+            return FieldCount > 1 ? p : end;
+        } else {
+            if constexpr (FieldCount == 1) return end;
+            return (const char*)std::memchr(begin, ',', (size_t)(end - begin));
+        }
+    }
+
+    template <size_t I>
+    static bool parseField(const char*& p, const char* end, Row& row) {
+        using Field = FieldAt<I>;
+        const char* stop;
+        if constexpr (I == 0) {
+            stop = firstFieldEnd(p, end);
+        } else if constexpr (I + 1 == FieldCount) {
+            stop = end;
+            // Text would swallow extra columns; numbers reject the comma on their own
+            if constexpr (std::is_same_v<typename Field::Type, std::string> ||
+                          std::is_same_v<typename Field::Type, std::string_view>) {
+                if (std::memchr(p, ',', (size_t)(end - p))) return false;
+            }
+        } else {
+            stop = (const char*)std::memchr(p, ',', (size_t)(end - p));
+        }
+        if (!stop || !Field::Format::parse(p, stop, row.*Field::member)) return false;
+        p = stop + 1;
+        return true;
+    }
+
+    template <size_t... I>
+    static int parseFields(const char* p, const char* end, Row& row, std::index_sequence<I...>) {
+        int failed = -1;
+        (void)((parseField<I>(p, end, row) || ((failed = (int)I), false)) && ...);
+        return failed;
+    }
+
+    template <size_t I>
+    static char* writeField(char* out, char* limit, const Row& row) {
+        using Field = FieldAt<I>;
+        if (!out) return nullptr;
+        if constexpr (I > 0) {
+            if (out == limit) return nullptr;
+            *out++ = ',';
+        }
+        return Field::Format::write(out, limit, row.*Field::member);
+    }
+
+    template <size_t... I>
+    static char* writeFields(char* out, char* limit, const Row& row, std::index_sequence<I...>) {
+        ((out = writeField<I>(out, limit, row)), ...);
+        return out;
+    }
+
+public:
+    constexpr explicit CsvSchema(Fields... fields) : fields(fields...) {}
+
+    // Header name of a column
+    const char* name(size_t column) const {
+        const char* result = "";
+        size_t i = 0;
+        std::apply([&](const Fields&... field) { ((i++ == column ? (void)(result = field.name) : (void)0), ...); },
+                   fields);
+        return result;
+    }
+
+    // Parses one line (without its newline; a trailing '\r' is ignored) into row.
+    // Returns -1 on success, otherwise the index of the first column that is missing or malformed.
+    static int parse(const char* begin, const char* end, Row& row) {
+        if (end > begin && end[-1] == '\r') end--;
+        return parseFields(begin, end, row, std::index_sequence_for<Fields...>());
+    }
+
+    // Writes one row and its newline to [out, limit); returns the new end, or nullptr if it does not fit
+    static char* write(char* out, char* limit, const Row& row) {
+        out = writeFields(out, limit, row, std::index_sequence_for<Fields...>());
+        if (!out || out == limit) return nullptr;
+        *out++ = '\n';
+        return out;
+    }
+
+    // Writes the header line; nullptr if it does not fit
+    char* writeHeader(char* out, char* limit) const {
+        for (size_t i = 0; i < FieldCount; i++) {
+            std::string_view text = name(i);
+            if (text.size() + 1 > (size_t)(limit - out)) return nullptr;
+            std::memcpy(out, text.data(), text.size());
+            out += text.size();
+            *out++ = i + 1 < FieldCount ? ',' : '\n';
+        }
+        return out;
+    }
+
+    // Checks a header line against the column names (exact match, in order). False with a
+    // description in error if they differ.
+    bool checkHeader(const char* begin, const char* end, std::string& error) const {
+        if (end > begin && end[-1] == '\r') end--;
+        const char* p = begin;
+        for (size_t i = 0; i < FieldCount; i++) {
+            if (p > end) {
+                error = "header has " + std::to_string(i) + " columns, expected " + std::to_string(FieldCount);
+                return false;
+            }
+            const char* stop = (const char*)std::memchr(p, ',', (size_t)(end - p));
+            if (!stop) stop = end;
+            if (std::string_view(p, (size_t)(stop - p)) != name(i)) {
+                error = "header column " + std::to_string(i + 1) + " is \"" + std::string(p, stop) +
+                        "\", expected \"" + name(i) + "\"";
+                return false;
+            }
+            p = stop + 1;
+        }
+        if (p <= end) {
+            error = "header has more than " + std::to_string(FieldCount) + " columns";
+            return false;
+        }
+        return true;
+    }
+};
+
+// Parses every line of a CSV text with a schema. onRow(row, line) gets each valid row,
+// onError(line, message) each header mismatch or malformed row (line numbers start at 1).
+// Blank lines are skipped. Returns the number of valid rows.
+template <typename Schema, typename OnRow, typename OnError>
+size_t parseCsvText(const Schema& schema, const char* begin, const char* end, bool hasHeader, OnRow onRow,
+                    OnError onError) {
+    typename Schema::Row row{};
+    size_t rows = 0, line = 0;
+    const char* p = begin;
+    while (p < end) {
+        const char* nl = (const char*)std::memchr(p, '\n', (size_t)(end - p));
+        const char* lineEnd = nl ? nl : end;
+        line++;
+        if (hasHeader && line == 1) {
+            std::string error;
+            if (!schema.checkHeader(p, lineEnd, error)) onError(line, error);
+        } else if (lineEnd > p && !(lineEnd - p == 1 && *p == '\r')) {
+            int failed = schema.parse(p, lineEnd, row);
+            if (failed < 0) {
+                onRow(row, line);
+                rows++;
+            } else {
+                onError(line, std::string("missing or malformed ") + schema.name((size_t)failed));
+            }
+        }
+        p = nl ? nl + 1 : end;
+    }
+    return rows;
+}
@@ -0,0 +1,178 @@
+#include "inventoryindex.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define INDEX_PREFETCH(address) __builtin_prefetch(address)
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <xmmintrin.h>
+#define INDEX_PREFETCH(address) _mm_prefetch((const char*)(address), _MM_HINT_T0)
+#else
+#define INDEX_PREFETCH(address) ((void)0)
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*
+This source file implements the Eytzinger IdIndex and the open-addressing
+NameIndex declared in inventoryindex.h.
+*/
+
+const size_t LineKeys = 64 / sizeof(int32_t); // Keys per cache line
+
+// ---------------------------------------------------------------- IdIndex
+
+// Number of trailing zero bits (x != 0)
+static int trailingZeros(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long bit;
+    _BitScanForward64(&bit, x);
+    return (int)bit;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+// Writes sorted[next...] into the subtree rooted at k, in order
+static void fillEytzinger(const std::vector<std::pair<int32_t, uint32_t>>& sorted, size_t& next, size_t k,
+                          int32_t* keys, uint32_t* rows, size_t count) {
+    if (k > count) return;
+    fillEytzinger(sorted, next, 2 * k, keys, rows, count);
+    keys[k] = sorted[next].first;
+    rows[k] = sorted[next].second;
+    next++;
+    fillEytzinger(sorted, next, 2 * k + 1, keys, rows, count);
+}
+
+void IdIndex::build(const int32_t* ids, size_t n) {
+    std::vector<std::pair<int32_t, uint32_t>> sorted(n);
+    for (size_t i = 0; i < n; i++) sorted[i] = {ids[i], (uint32_t)i};
+    std::sort(sorted.begin(), sorted.end()); // By ID, then row, so the first row of a duplicate comes first
+    sorted.erase(std::unique(sorted.begin(), sorted.end(),
+                             [](const auto& a, const auto& b) { return a.first == b.first; }),
+                 sorted.end());
+    count = sorted.size();
+
+    // Position 0 is unused; line up position 0 with a cache line so positions 16k..16k+15 share one
+    storage.assign(count + 1 + LineKeys, 0);
+    uintptr_t address = (uintptr_t)storage.data();
+    keyOffset = (64 - address % 64) % 64 / sizeof(int32_t);
+    rows.assign(count + 1, 0);
+    size_t next = 0;
+    fillEytzinger(sorted, next, 1, storage.data() + keyOffset, rows.data(), count);
+}
+
+int64_t IdIndex::find(int32_t id) const {
+    const int32_t* b = keys();
+    size_t k = 1;
+    while (k <= count) {
+        INDEX_PREFETCH(b + std::min(k * LineKeys, count)); // The line four levels down
+        k = 2 * k + (b[k] < id);
+    }
+    // k went right (low bit 1) after the last key >= id; dropping those moves and one more
+    // left step gives that key's position, or 0 if every key is smaller
+    k >>= trailingZeros(~(uint64_t)k) + 1;
+    return k != 0 && b[k] == id ? (int64_t)rows[k] : -1;
+}
+
+size_t IdIndex::size() const {
+    return count;
+}
+
+// ---------------------------------------------------------------- NameIndex
+
+// murmur3's 64-bit finalizer: every input bit affects every output bit
+static uint64_t mix64(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+// 64-bit hash of a name, 8 bytes at a time. The last 8 bytes are read again (overlapping) rather
+// than copying a variable-length tail, which costs a memcpy call per hash.
+static uint64_t hashName(std::string_view name) {
+    const char* p = name.data();
+    size_t n = name.size();
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ (uint64_t)n;
+    uint64_t w = 0;
+    if (n >= 8) {
+        for (size_t i = 0; i + 8 < n; i += 8) {
+            std::memcpy(&w, p + i, 8);
+            h = (h ^ w) * 0xFF51AFD7ED558CCDull;
+            h ^= h >> 32;
+        }
+        std::memcpy(&w, p + n - 8, 8);
+    } else {
+        for (size_t i = 0; i < n; i++) w |= (uint64_t)(unsigned char)p[i] << (8 * i);
+    }
+    return mix64(h ^ w);
+}
+
+NameIndex::NameIndex() {
+    clear();
+}
+
+std::string_view NameIndex::name(const Slot& slot) const {
+    uint64_t span = slot.span - 1;
+    return std::string_view(arena.data() + (span >> 16), (size_t)(span & 0xFFFF));
+}
+
+void NameIndex::reserve(size_t names) {
+    size_t capacity = slots.size();
+    while (capacity < names * 2) capacity *= 2;
+    if (capacity == slots.size()) return;
+    std::vector<Slot> old(capacity, Slot{0, 0, 0});
+    old.swap(slots);
+    size_t mask = capacity - 1;
+    for (const Slot& slot : old) {
+        if (slot.span == 0) continue;
+        size_t i = (size_t)hashName(name(slot)) & mask;
+        while (slots[i].span != 0) i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+}
+
+void NameIndex::grow() {
+    reserve(slots.size()); // Twice as many names as now fit at half load
+}
+
+bool NameIndex::insert(std::string_view text, uint32_t row) {
+    if (text.size() > 0xFFFF) return false;
+    if ((count + 1) * 2 > slots.size()) grow();
+    uint64_t h = hashName(text);
+    uint32_t tag = (uint32_t)(h >> 32);
+    size_t mask = slots.size() - 1;
+    size_t i = (size_t)h & mask;
+    for (; slots[i].span != 0; i = (i + 1) & mask) {
+        if (slots[i].tag == tag && name(slots[i]) == text) return false;
+    }
+    slots[i] = Slot{tag, row, ((uint64_t)arena.size() << 16 | text.size()) + 1};
+    arena.insert(arena.end(), text.begin(), text.end());
+    count++;
+    return true;
+}
+
+int64_t NameIndex::find(std::string_view text) const {
+    uint64_t h = hashName(text);
+    uint32_t tag = (uint32_t)(h >> 32);
+    size_t mask = slots.size() - 1;
+    for (size_t i = (size_t)h & mask; slots[i].span != 0; i = (i + 1) & mask) {
+        if (slots[i].tag == tag && name(slots[i]) == text) return slots[i].row;
+    }
+    return -1;
+}
+
+size_t NameIndex::size() const {
+    return count;
+}
+
+void NameIndex::clear() {
+    slots.assign(16, Slot{0, 0, 0});
+    arena.clear();
+    count = 0;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/*
+This header file defines two lookup indexes for inventories too large to
+scan: IdIndex for integer item IDs and NameIndex for item names. Both
+map a key to the item's position (row) in the caller's own array, so the
+items themselves never move.
+
+IdIndex keeps the sorted IDs in Eytzinger (breadth-first) order: the
+root at index 1, the children of k at 2k and 2k+1. A lookup walks down
+with k = 2k + (key < id), which compiles to a conditional move instead
+of a branch the CPU would mispredict half the time. Sixteen 4-byte keys
+fill one cache line and the 16 descendants four levels below k are
+contiguous, so each step prefetches the line it will need four steps
+later; out of cache, the memory latency of a lookup overlaps instead of
+adding up level by level.
+
+NameIndex is an open-addressing hash table with linear probing, kept at
+most half full. Each 16-byte slot holds 32 bits of the name's hash, the
+row and where the name sits in the index's own arena, so a lookup reads
+one slot line and compares the name (one more line) only when the hash
+bits match.
+*/
+
+class IdIndex {
+private:
+    std::vector<int32_t> storage; // Keys, padded so that keys() is 64-byte aligned
+    size_t keyOffset = 0;         // Index in storage of Eytzinger position 0 (unused)
+    std::vector<uint32_t> rows;   // Row of the key at each Eytzinger position
+    size_t count = 0;
+
+    const int32_t* keys() const { return storage.data() + keyOffset; }
+
+public:
+    // Indexes ids[0..count); ids need not be sorted. With duplicate IDs the first row wins.
+    void build(const int32_t* ids, size_t count);
+
+    int64_t find(int32_t id) const; // Row of the item with this ID, or -1
+    size_t size() const;            // Distinct IDs indexed
+};
+
+class NameIndex {
+private:
+    struct Slot {
+        uint32_t tag;  // Top 32 bits of the name's hash
+        uint32_t row;
+        uint64_t span; // (offset << 16 | length) + 1 of the name in the arena; 0 marks an empty slot
+    };
+
+    std::vector<Slot> slots;       // Capacity is a power of two
+    std::vector<char> arena;       // Every name, back to back
+    size_t count = 0;
+
+    std::string_view name(const Slot& slot) const;
+    void grow();                    // Doubles the slot array and reinserts every name
+
+public:
+    NameIndex();
+
+    void reserve(size_t names);                       // Sizes the table for this many names
+    // False (and unchanged) if the name is already indexed or longer than 65535 bytes
+    bool insert(std::string_view name, uint32_t row);
+    int64_t find(std::string_view name) const;        // Row of the item with this name, or -1
+    size_t size() const;                              // Names indexed
+    void clear();
+};
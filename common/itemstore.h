@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+This header file defines ItemStore, an inventory holding several item
+kinds (Perishable, NonPerishable, ...) without a base-class pointer per
+item.
+
+Each kind has its own contiguous std::vector, so adding an item never
+allocates it separately and walking the inventory reads memory in order.
+forEach() runs a generic callback over one kind's array after another;
+the kind is known at compile time inside each loop, so calls such as
+item.display() are direct (and usually inlined) instead of going through
+a vtable per item.
+
+A Handle (kind number and position) names one item, and visit() calls
+back with that item as its real type. Adding items may move the arrays,
+so keep handles rather than references; removeIf() also moves items and
+invalidates handles.
+*/
+
+template <typename... Kinds>
+class ItemStore {
+private:
+    std::tuple<std::vector<Kinds>...> kinds;
+
+    // Position of T in Kinds (kindCount if T is not one of them)
+    template <typename T>
+    static constexpr size_t indexOf() {
+        constexpr bool matches[] = {std::is_same<T, Kinds>::value...};
+        for (size_t i = 0; i < sizeof...(Kinds); i++) {
+            if (matches[i]) return i;
+        }
+        return sizeof...(Kinds);
+    }
+
+    template <typename Items, typename Fn>
+    static void forEachIn(Items& items, Fn& fn) {
+        for (auto& item : items) fn(item);
+    }
+
+    template <typename Items, typename Pred>
+    static size_t removeIn(Items& items, Pred& pred) {
+        size_t before = items.size();
+        size_t kept = 0;
+        for (size_t i = 0; i < before; i++) {
+            if (pred(items[i])) continue;
+            if (kept != i) items[kept] = std::move(items[i]);
+            kept++;
+        }
+        items.erase(items.begin() + kept, items.end());
+        return before - kept;
+    }
+
+    template <typename Fn, size_t... I>
+    void visitAt(uint32_t kind, uint32_t position, Fn& fn, std::index_sequence<I...>) {
+        // Exactly one I matches; each branch calls fn with that kind's real type
+        (void)((kind == I ? (fn(std::get<I>(kinds)[position]), true) : false) || ...);
+    }
+
+public:
+    struct Handle {
+        uint32_t kind;     // Index of the item's type in Kinds
+        uint32_t position; // Index in that kind's array
+    };
+
+    static constexpr size_t kindCount = sizeof...(Kinds);
+
+    // Constructs an item of kind T in place and returns its handle
+    template <typename T, typename... Args>
+    Handle emplace(Args&&... args) {
+        static_assert(indexOf<T>() < kindCount, "T is not a kind of this store");
+        std::vector<T>& items = std::get<std::vector<T>>(kinds);
+        items.emplace_back(std::forward<Args>(args)...);
+        return Handle{(uint32_t)indexOf<T>(), (uint32_t)(items.size() - 1)};
+    }
+
+    template <typename T>
+    Handle add(T item) {
+        return emplace<T>(std::move(item));
+    }
+
+    template <typename T>
+    void reserve(size_t count) {
+        std::get<std::vector<T>>(kinds).reserve(count);
+    }
+
+    // Every item of kind T, contiguous
+    template <typename T>
+    std::vector<T>& all() {
+        return std::get<std::vector<T>>(kinds);
+    }
+
+    template <typename T>
+    const std::vector<T>& all() const {
+        return std::get<std::vector<T>>(kinds);
+    }
+
+    // Calls fn(item) for every item, kind by kind in the order of Kinds
+    template <typename Fn>
+    void forEach(Fn&& fn) {
+        std::apply([&](auto&... items) { (forEachIn(items, fn), ...); }, kinds);
+    }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        std::apply([&](const auto&... items) { (forEachIn(items, fn), ...); }, kinds);
+    }
+
+    // Calls fn(item) with the item a handle names, as its own type
+    template <typename Fn>
+    void visit(Handle handle, Fn&& fn) {
+        visitAt(handle.kind, handle.position, fn, std::index_sequence_for<Kinds...>());
+    }
+
+    // Removes every item for which pred(item) is true, keeping the others in order. Invalidates handles.
+    template <typename Pred>
+    size_t removeIf(Pred&& pred) {
+        size_t removed = 0;
+        std::apply([&](auto&... items) { ((removed += removeIn(items, pred)), ...); }, kinds);
+        return removed;
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        std::apply([&](const auto&... items) { ((total += items.size()), ...); }, kinds);
+        return total;
+    }
+
+    template <typename T>
+    size_t count() const {
+        return std::get<std::vector<T>>(kinds).size();
+    }
+
+    void clear() {
+        std::apply([](auto&... items) { (items.clear(), ...); }, kinds);
+    }
+};
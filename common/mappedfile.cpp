@@ -0,0 +1,213 @@
+#include "mappedfile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+This source file implements the MappedFile class declared in mappedfile.h.
+*/
+
+MappedFile::MappedFile() {
+    bytes = nullptr;
+    length = 0;
+    writable = false;
+#ifdef _WIN32
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+#else
+    fd = -1;
+#endif
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    fileHandle = file;
+    length = (size_t)fileSize.QuadPart;
+    if (length == 0) return true; // Nothing to map, but the file exists
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        close();
+        return false;
+    }
+    mappingHandle = mapping;
+    bytes = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close();
+        return false;
+    }
+    length = (size_t)info.st_size;
+    if (length == 0) return true; // Nothing to map, but the file exists
+    void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+        close();
+        return false;
+    }
+    madvise(p, length, MADV_SEQUENTIAL); // We read front to back
+    bytes = (const char*)p;
+#endif
+    if (!bytes) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (bytes) UnmapViewOfFile(bytes);
+    if (mappingHandle) CloseHandle((HANDLE)mappingHandle);
+    if (fileHandle) CloseHandle((HANDLE)fileHandle);
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+#else
+    if (bytes) munmap((void*)bytes, length);
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+#endif
+    bytes = nullptr;
+    length = 0;
+    writable = false;
+}
+
+// ---------------------------------------------------------------- Writable mappings
+
+// Maps length bytes of the open file read-write, extending the file if needed; nullptr on failure
+static char* mapWritable(
+#ifdef _WIN32
+    void* fileHandle, void*& mappingHandle,
+#else
+    int fd,
+#endif
+    size_t length) {
+#ifdef _WIN32
+    // Creating a mapping larger than the file extends the file
+    HANDLE mapping = CreateFileMappingA((HANDLE)fileHandle, nullptr, PAGE_READWRITE, (DWORD)((uint64_t)length >> 32),
+                                        (DWORD)length, nullptr);
+    if (!mapping) return nullptr;
+    mappingHandle = mapping;
+    return (char*)MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, length);
+#else
+    struct stat info;
+    if (fstat(fd, &info) != 0) return nullptr;
+    if ((size_t)info.st_size < length && ftruncate(fd, (off_t)length) != 0) return nullptr;
+    void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    return p == MAP_FAILED ? nullptr : (char*)p;
+#endif
+}
+
+bool MappedFile::openWritable(const std::string& path, size_t minimumSize) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    fileHandle = file;
+    length = (size_t)fileSize.QuadPart;
+#else
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close();
+        return false;
+    }
+    length = (size_t)info.st_size;
+#endif
+    if (length < minimumSize) length = minimumSize;
+    if (length == 0) {
+        close();
+        return false; // A mapping cannot be empty
+    }
+#ifdef _WIN32
+    bytes = mapWritable(fileHandle, mappingHandle, length);
+#else
+    bytes = mapWritable(fd, length);
+#endif
+    if (!bytes) {
+        close();
+        return false;
+    }
+    writable = true;
+    return true;
+}
+
+bool MappedFile::grow(size_t newSize) {
+    if (!writable) return false;
+    if (newSize <= length) return true;
+    // Map the new size before letting go of the old mapping: on failure the old one stays usable
+#ifdef _WIN32
+    void* newMapping = nullptr;
+    char* p = mapWritable(fileHandle, newMapping, newSize);
+    if (!p) {
+        if (newMapping) CloseHandle((HANDLE)newMapping);
+        return false;
+    }
+    UnmapViewOfFile(bytes);
+    CloseHandle((HANDLE)mappingHandle);
+    mappingHandle = newMapping;
+#else
+    char* p = mapWritable(fd, newSize);
+    if (!p) return false;
+    munmap((void*)bytes, length);
+#endif
+    bytes = p;
+    length = newSize;
+    return true;
+}
+
+bool MappedFile::flush(size_t offset, size_t count) {
+    if (!writable || offset >= length) return false;
+    if (count > length - offset) count = length - offset;
+#ifdef _WIN32
+    return FlushViewOfFile(bytes + offset, count) && FlushFileBuffers((HANDLE)fileHandle);
+#else
+    // msync needs a page-aligned start
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t start = offset / page * page;
+    return msync((void*)(bytes + start), offset + count - start, MS_SYNC) == 0;
+#endif
+}
+
+char* MappedFile::writableData() {
+    return writable ? (char*)bytes : nullptr;
+}
+
+// ---------------------------------------------------------------- Access
+
+const char* MappedFile::data() const {
+    return bytes;
+}
+
+size_t MappedFile::size() const {
+    return length;
+}
+
+bool MappedFile::isOpen() const {
+#ifdef _WIN32
+    return fileHandle != nullptr;
+#else
+    return fd >= 0;
+#endif
+}
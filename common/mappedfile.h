@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/*
+This header file defines the MappedFile class.
+It maps a whole file into memory read-only so large CSV files can be
+parsed in place without copying them into std::string buffers.
+Works on both Windows (file mapping objects) and POSIX (mmap).
+
+openWritable() maps a file read-write and shared instead: stores through
+writableData() change the file itself, grow() extends it, and flush()
+writes a byte range back to disk (msync / FlushViewOfFile) and waits.
+*/
+
+class MappedFile {
+private:
+    const char* bytes;   // Start of the mapping (nullptr if not open)
+    size_t length;       // Size of the mapped file in bytes
+    bool writable;       // Mapped read-write by openWritable()
+#ifdef _WIN32
+    void* fileHandle;    // HANDLE of the open file
+    void* mappingHandle; // HANDLE of the file mapping object
+#else
+    int fd;              // Descriptor of the open file
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path); // Maps the whole file; false if it cannot be opened
+    void close();                       // Unmaps and closes the file
+
+    // Maps the file read-write, creating it or extending it (with zero bytes) to at least
+    // minimumSize. False if it cannot be opened or mapped.
+    bool openWritable(const std::string& path, size_t minimumSize);
+    // Extends a writable file and remaps it; data() may move. On failure the old mapping stays.
+    bool grow(size_t newSize);
+    bool flush(size_t offset, size_t count);  // Writes the pages holding [offset, offset + count) and waits
+    char* writableData();                     // Start of a writable mapping (nullptr if read-only)
+
+    const char* data() const;           // Start of the file contents
+    size_t size() const;                // Number of bytes in the file
+    bool isOpen() const;                // True while a file is mapped (an empty file counts as open)
+};
@@ -0,0 +1,213 @@
+#include "mappedinventory.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+/*
+This source file implements the memory-mapped MappedInventory declared
+in mappedinventory.h.
+*/
+
+const char InventoryMagic[8] = {'I', 'N', 'V', 'E', 'N', 'T', 'R', 'Y'};
+const uint32_t InventoryVersion = 1;
+const uint32_t ByteOrderMark = 0x01020304; // Reads back differently on a machine of the other endianness
+const size_t InitialNameBytes = 1 << 16;
+
+struct InventoryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t capacity;   // Record slots that follow the header
+    char reserved[40];
+};
+
+static_assert(sizeof(InventoryHeader) == sizeof(InventoryRecord), "Records stay 64-byte aligned");
+
+// ---------------------------------------------------------------- Files
+
+InventoryRecord* MappedInventory::record(uint32_t id) {
+    return (InventoryRecord*)(records.writableData() + sizeof(InventoryHeader)) + id;
+}
+
+const InventoryRecord* MappedInventory::record(uint32_t id) const {
+    return (const InventoryRecord*)(records.data() + sizeof(InventoryHeader)) + id;
+}
+
+bool MappedInventory::flushRecord(uint32_t id, size_t offset, size_t bytes) {
+    return !sync || records.flush(sizeof(InventoryHeader) + (size_t)id * sizeof(InventoryRecord) + offset, bytes);
+}
+
+bool MappedInventory::open(const std::string& path, const InventoryOptions& options) {
+    close();
+    sync = options.sync;
+    // Only a missing or empty file may be extended before its header is checked; anything else
+    // too short for a header is not an inventory and is left alone
+    std::error_code error;
+    uint64_t existing = std::filesystem::file_size(path, error);
+    if (!error && existing > 0 && existing < sizeof(InventoryHeader)) return false;
+    if (!records.openWritable(path, sizeof(InventoryHeader))) return false;
+
+    InventoryHeader header;
+    std::memcpy(&header, records.data(), sizeof(header));
+    const InventoryHeader blank = {};
+    if (std::memcmp(&header, &blank, sizeof(header)) == 0) {
+        // A new file (or one created by a run that crashed before writing the header)
+        size_t initial = std::max<size_t>(options.initialCapacity, 1);
+        std::memcpy(header.magic, InventoryMagic, sizeof(InventoryMagic));
+        header.version = InventoryVersion;
+        header.byteOrder = ByteOrderMark;
+        header.capacity = initial;
+        if (!records.grow(sizeof(InventoryHeader) + initial * sizeof(InventoryRecord))) {
+            close();
+            return false;
+        }
+        std::memcpy(records.writableData(), &header, sizeof(header));
+        if (!records.flush(0, sizeof(header))) {
+            close();
+            return false;
+        }
+    } else if (std::memcmp(header.magic, InventoryMagic, sizeof(InventoryMagic)) != 0 ||
+               header.version != InventoryVersion || header.byteOrder != ByteOrderMark || header.capacity == 0 ||
+               header.capacity > UINT32_MAX ||
+               sizeof(InventoryHeader) + header.capacity * sizeof(InventoryRecord) > records.size()) {
+        close();
+        return false;
+    }
+    if (!names.openWritable(path + ".names", InitialNameBytes)) {
+        close();
+        return false;
+    }
+
+    slots = (uint32_t)header.capacity;
+
+    // Rebuild what is not stored: the item count, the free slots and the end of the names in use
+    for (uint32_t id = (uint32_t)header.capacity; id-- > 0;) {
+        const InventoryRecord* r = record(id);
+        if (r->used != 1) {
+            freeSlots.push_back(id);
+            continue;
+        }
+        count++;
+        if (r->nameLength > InventoryInlineName) namesEnd = std::max(namesEnd, r->nameOffset + r->nameLength);
+    }
+    return true;
+}
+
+void MappedInventory::close() {
+    records.close();
+    names.close();
+    namesEnd = 0;
+    freeSlots.clear();
+    count = 0;
+    slots = 0;
+}
+
+bool MappedInventory::growRecords() {
+    uint32_t oldCapacity = capacity();
+    uint64_t newCapacity = (uint64_t)oldCapacity * 2;
+    if (newCapacity > UINT32_MAX) return false;
+    if (!records.grow(sizeof(InventoryHeader) + newCapacity * sizeof(InventoryRecord))) return false;
+
+    // The file is extended before the header claims the new slots, so a crash in between only
+    // leaves unused space at the end
+    InventoryHeader header;
+    std::memcpy(&header, records.data(), sizeof(header));
+    header.capacity = newCapacity;
+    std::memcpy(records.writableData(), &header, sizeof(header));
+    if (sync && !records.flush(0, sizeof(header))) return false;
+    slots = (uint32_t)newCapacity;
+    for (uint32_t id = slots; id-- > oldCapacity;) freeSlots.push_back(id);
+    return true;
+}
+
+bool MappedInventory::storeName(std::string_view text, InventoryRecord& r) {
+    r.nameLength = (uint32_t)text.size();
+    r.nameOffset = 0;
+    if (text.size() <= InventoryInlineName) {
+        std::memcpy(r.name, text.data(), text.size());
+        return true;
+    }
+    size_t size = names.size();
+    while (size < namesEnd + text.size()) size *= 2;
+    if (!names.grow(size)) return false;
+    std::memcpy(names.writableData() + namesEnd, text.data(), text.size());
+    // Durable before the record that points at it
+    if (sync && !names.flush((size_t)namesEnd, text.size())) return false;
+    r.nameOffset = namesEnd;
+    namesEnd += text.size();
+    return true;
+}
+
+// ---------------------------------------------------------------- Items
+
+int64_t MappedInventory::add(std::string_view text, int64_t amount) {
+    if (!records.isOpen() || text.size() > UINT32_MAX) return -1;
+    if (freeSlots.empty() && !growRecords()) return -1;
+    uint32_t id = freeSlots.back();
+
+    InventoryRecord filled;
+    std::memset(&filled, 0, sizeof(filled));
+    filled.quantity = amount;
+    if (!storeName(text, filled)) return -1;
+    InventoryRecord* r = record(id);
+    std::memcpy(r, &filled, sizeof(filled));
+    r->used = 1; // Last, so a half-written record is never taken for an item
+    if (!flushRecord(id, 0, sizeof(InventoryRecord))) return -1;
+
+    freeSlots.pop_back();
+    count++;
+    return id;
+}
+
+bool MappedInventory::remove(uint32_t id) {
+    if (!contains(id)) return false;
+    record(id)->used = 0;
+    freeSlots.push_back(id);
+    count--;
+    return flushRecord(id, offsetof(InventoryRecord, used), sizeof(uint32_t));
+}
+
+bool MappedInventory::setQuantity(uint32_t id, int64_t amount) {
+    if (!contains(id)) return false;
+    record(id)->quantity = amount;
+    return flushRecord(id, offsetof(InventoryRecord, quantity), sizeof(int64_t));
+}
+
+bool MappedInventory::addQuantity(uint32_t id, int64_t delta) {
+    return contains(id) && setQuantity(id, record(id)->quantity + delta);
+}
+
+bool MappedInventory::contains(uint32_t id) const {
+    return id < slots && record(id)->used == 1;
+}
+
+int64_t MappedInventory::quantity(uint32_t id) const {
+    return contains(id) ? record(id)->quantity : 0;
+}
+
+std::string_view MappedInventory::name(uint32_t id) const {
+    if (!contains(id)) return std::string_view();
+    const InventoryRecord* r = record(id);
+    if (r->nameLength <= InventoryInlineName) return std::string_view(r->name, r->nameLength);
+    if (r->nameOffset + r->nameLength > names.size()) return std::string_view(); // Damaged record
+    return std::string_view(names.data() + r->nameOffset, r->nameLength);
+}
+
+int64_t MappedInventory::find(std::string_view text) const {
+    for (uint32_t id = 0; id < slots; id++) {
+        if (contains(id) && name(id) == text) return id;
+    }
+    return -1;
+}
+
+size_t MappedInventory::size() const {
+    return count;
+}
+
+uint32_t MappedInventory::capacity() const {
+    return slots;
+}
+
+bool MappedInventory::flush() {
+    return records.isOpen() && records.flush(0, records.size()) && names.flush(0, names.size());
+}
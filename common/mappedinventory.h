@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "mappedfile.h"
+
+/*
+This header file defines MappedInventory, an inventory kept in a
+memory-mapped file so that changing one item costs one page of I/O
+instead of rewriting the whole file.
+
+The file (e.g. items.inv) is a 64-byte header followed by fixed 64-byte
+records, one per item slot; an item's id is its slot number and never
+changes. Names of up to 40 bytes live in the record; longer ones go to
+an append-only overflow file beside it (items.inv.names). Both files
+grow by doubling, so adding n items remaps O(log n) times.
+
+Changes are stores into the mapping. With sync on (the default) each
+change then flushes just the pages it touched (msync of that range), so
+setQuantity() is one 8-byte store and one page write. An added record
+is filled in before it is marked used, and freed slots (from remove())
+are reused before the file grows. The free list and item count are
+rebuilt from the records when the file is opened, so they are never out
+of date after a crash.
+
+Not thread-safe: one owner at a time, like std::vector.
+*/
+
+const size_t InventoryInlineName = 40; // Longer names go to the overflow file
+
+// One item slot as stored in the file (64 bytes, native byte order)
+struct InventoryRecord {
+    int64_t quantity;
+    uint64_t nameOffset;   // Position in the overflow file (long names only)
+    uint32_t nameLength;
+    uint32_t used;         // 1 for an item, 0 for a free slot; set last when an item is added
+    char name[InventoryInlineName]; // Short names; not NUL-terminated
+};
+
+static_assert(sizeof(InventoryRecord) == 64, "Inventory records are one cache line");
+
+struct InventoryOptions {
+    bool sync = true;              // Flush every change to disk before returning
+    size_t initialCapacity = 1024; // Slots in a new file
+};
+
+class MappedInventory {
+private:
+    MappedFile records;              // Header, then the records
+    MappedFile names;                // Overflow names, back to back
+    uint64_t namesEnd = 0;           // Bytes of the overflow file in use
+    std::vector<uint32_t> freeSlots; // Unused slots, taken from the back
+    size_t count = 0;                // Items stored
+    uint32_t slots = 0;              // Record slots in the file (the header's capacity)
+    bool sync = true;
+
+    InventoryRecord* record(uint32_t id);
+    const InventoryRecord* record(uint32_t id) const;
+    bool flushRecord(uint32_t id, size_t offset, size_t bytes); // Part of one record, if syncing
+    bool growRecords();   // Doubles the slots
+    bool storeName(std::string_view name, InventoryRecord& record);
+
+public:
+    // Opens or creates the inventory files. False if they cannot be opened or are not inventories.
+    bool open(const std::string& path, const InventoryOptions& options = InventoryOptions());
+    void close();
+
+    int64_t add(std::string_view name, int64_t quantity); // The new item's id, or -1 if it cannot be stored
+    bool remove(uint32_t id);                              // Frees the slot for a later add()
+    bool setQuantity(uint32_t id, int64_t quantity);       // In place; false if there is no such item
+    bool addQuantity(uint32_t id, int64_t delta);
+
+    bool contains(uint32_t id) const;
+    int64_t quantity(uint32_t id) const;       // 0 if there is no such item
+    std::string_view name(uint32_t id) const;  // Points into the mapping; valid until the next add()
+    int64_t find(std::string_view name) const; // Id of the first item with this name, or -1 (a scan)
+
+    size_t size() const;         // Items stored
+    uint32_t capacity() const;   // Slots in the file; ids are below this
+    bool flush();                // Writes every change to disk (for sync off)
+};
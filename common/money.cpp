@@ -0,0 +1,42 @@
+#include "money.h"
+
+/*
+This source file implements the cent parsing and formatting declared in
+money.h.
+*/
+
+bool parseCents(const std::string& text, Cents& amount) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < text.size() && (text[i] == '-' || text[i] == '+')) negative = text[i++] == '-';
+    Cents whole = 0;
+    size_t digits = 0;
+    for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; i++, digits++) {
+        if (whole > (INT64_MAX / 100 - 9) / 10) return false; // Would overflow once scaled
+        whole = whole * 10 + (text[i] - '0');
+    }
+    Cents fraction = 0;
+    if (i < text.size() && text[i] == '.') {
+        i++;
+        int decimals = 0;
+        for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; i++, digits++) {
+            if (++decimals > 2) return false; // Below a cent
+            fraction = fraction * 10 + (text[i] - '0');
+        }
+        if (decimals == 1) fraction *= 10;
+    }
+    if (digits == 0 || i != text.size()) return false;
+    amount = whole * 100 + fraction;
+    if (negative) amount = -amount;
+    return true;
+}
+
+std::string formatCents(Cents amount) {
+    uint64_t magnitude = amount < 0 ? 0 - (uint64_t)amount : (uint64_t)amount;
+    std::string text = std::to_string(magnitude / 100);
+    unsigned cents = (unsigned)(magnitude % 100);
+    text += '.';
+    text += (char)('0' + cents / 10);
+    text += (char)('0' + cents % 10);
+    return amount < 0 ? "-" + text : text;
+}
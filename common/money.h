@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/*
+This header file defines Cents, money as an exact count of minor units,
+so sums never drift the way float or double amounts do, and its
+conversions to and from text.
+*/
+
+using Cents = int64_t; // Money in minor units: $10.50 is 1050
+
+bool parseCents(const std::string& text, Cents& amount); // "10.50", "-3", "7.5"; false if malformed
+std::string formatCents(Cents amount);                   // 1050 -> "10.50"
@@ -0,0 +1,228 @@
+#include "pricing.h"
+#include <algorithm>
+#include <vector>
+#include "cpu.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PRICING_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+This source file implements the pricing kernels and the batch functions
+declared in pricing.h.
+
+SIMD has no 64-bit integer division, so the AVX-512 line kernel divides
+by 10000 with a multiply: for every 64-bit x, x / 10000 is the high 64
+bits of x * DivideMagic shifted right by DivideShift. The 64 x 64-bit
+high product is built from four 32 x 32-bit multiplies. At four lanes
+that costs more than the scalar loop, whose compiler-generated division
+is one 64-bit multiply, so AVX2 only gets a valuation kernel.
+*/
+
+const size_t BlockLines = 4096;                       // Line totals computed together by priceOrders
+const size_t ParallelLines = 16 * BlockLines;         // Fewer lines per thread run on one thread
+const uint64_t DivideMagic = 0x346DC5D63886594Bull;   // ceil(2^75 / 10000)
+const int DivideShift = 11;
+
+// ---------------------------------------------------------------- Scalar kernels
+
+bool lineValid(int32_t quantity, int32_t unitPrice, int32_t discount, int32_t tax) {
+    return quantity >= 0 && unitPrice >= 0 && discount >= 0 && discount <= MaxBasisPoints && tax >= 0 &&
+           tax <= MaxBasisPoints && (uint64_t)quantity * (uint64_t)unitPrice <= MaxLineGross;
+}
+
+Cents linePrice(int32_t quantity, int32_t unitPrice, int32_t discount, int32_t tax) {
+    uint64_t gross = (uint64_t)quantity * (uint32_t)unitPrice;
+    uint64_t net = gross - (gross * (uint32_t)discount + MaxBasisPoints / 2) / MaxBasisPoints;
+    return (Cents)(net + (net * (uint32_t)tax + MaxBasisPoints / 2) / MaxBasisPoints);
+}
+
+static void linesScalar(const int32_t* q, const int32_t* p, const int32_t* d, const int32_t* t, size_t n,
+                        Cents* out) {
+    for (size_t i = 0; i < n; i++) out[i] = linePrice(q[i], p[i], d[i], t[i]);
+}
+
+static uint64_t valueScalar(const int32_t* q, const int32_t* p, size_t n) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; i++) sum += (uint64_t)((int64_t)q[i] * p[i]);
+    return sum;
+}
+
+// ---------------------------------------------------------------- AVX2 / AVX-512 kernels
+
+#ifdef PRICING_X86
+
+#if defined(__GNUC__) || defined(__clang__)
+#define AVX2_TARGET __attribute__((target("avx2")))
+#define AVX512_TARGET __attribute__((target("avx512f")))
+#else
+#define AVX2_TARGET
+#define AVX512_TARGET
+#endif
+
+AVX2_TARGET static uint64_t valueAvx2(const int32_t* q, const int32_t* p, size_t n) {
+    // mul_epi32 multiplies the even 32-bit lanes as signed; shifting brings the odd ones down
+    __m256i even = _mm256_setzero_si256(), odd = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i quantity = _mm256_loadu_si256((const __m256i*)(q + i));
+        __m256i price = _mm256_loadu_si256((const __m256i*)(p + i));
+        even = _mm256_add_epi64(even, _mm256_mul_epi32(quantity, price));
+        odd = _mm256_add_epi64(odd, _mm256_mul_epi32(_mm256_srli_epi64(quantity, 32), _mm256_srli_epi64(price, 32)));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, _mm256_add_epi64(even, odd));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + valueScalar(q + i, p + i, n - i);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+// High 64 bits of x * m in each lane; mLo and mHi hold the halves of m in the low 32 bits of each lane
+AVX512_TARGET static inline __m512i mulHighAvx512(__m512i x, __m512i mLo, __m512i mHi) {
+    __m512i xHi = _mm512_srli_epi64(x, 32), low32 = _mm512_set1_epi64(0xFFFFFFFF);
+    __m512i ll = _mm512_mul_epu32(x, mLo), lh = _mm512_mul_epu32(x, mHi);
+    __m512i hl = _mm512_mul_epu32(xHi, mLo), hh = _mm512_mul_epu32(xHi, mHi);
+    __m512i mid = _mm512_add_epi64(_mm512_add_epi64(_mm512_srli_epi64(ll, 32), _mm512_and_si512(lh, low32)),
+                                   _mm512_and_si512(hl, low32));
+    __m512i high = _mm512_add_epi64(hh, _mm512_add_epi64(_mm512_srli_epi64(lh, 32), _mm512_srli_epi64(hl, 32)));
+    return _mm512_add_epi64(high, _mm512_srli_epi64(mid, 32));
+}
+
+// (amount * basisPoints + 5000) / 10000 per lane; basisPoints in the low 32 bits, amount * basisPoints < 2^64
+AVX512_TARGET static inline __m512i applyRateAvx512(__m512i amount, __m512i basisPoints, __m512i mLo, __m512i mHi) {
+    __m512i high = _mm512_mul_epu32(_mm512_srli_epi64(amount, 32), basisPoints);
+    __m512i product = _mm512_add_epi64(_mm512_mul_epu32(amount, basisPoints), _mm512_slli_epi64(high, 32));
+    product = _mm512_add_epi64(product, _mm512_set1_epi64(MaxBasisPoints / 2));
+    return _mm512_srli_epi64(mulHighAvx512(product, mLo, mHi), DivideShift);
+}
+
+AVX512_TARGET static void linesAvx512(const int32_t* q, const int32_t* p, const int32_t* d, const int32_t* t,
+                                      size_t n, Cents* out) {
+    __m512i mLo = _mm512_set1_epi64((int64_t)(DivideMagic & 0xFFFFFFFF));
+    __m512i mHi = _mm512_set1_epi64((int64_t)(DivideMagic >> 32));
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i quantity = _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i*)(q + i)));
+        __m512i price = _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i*)(p + i)));
+        __m512i discount = _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i*)(d + i)));
+        __m512i tax = _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i*)(t + i)));
+        __m512i gross = _mm512_mul_epu32(quantity, price);
+        __m512i net = _mm512_sub_epi64(gross, applyRateAvx512(gross, discount, mLo, mHi));
+        __m512i total = _mm512_add_epi64(net, applyRateAvx512(net, tax, mLo, mHi));
+        _mm512_storeu_si512((void*)(out + i), total);
+    }
+    linesScalar(q + i, p + i, d + i, t + i, n - i, out + i);
+}
+
+AVX512_TARGET static uint64_t valueAvx512(const int32_t* q, const int32_t* p, size_t n) {
+    __m512i even = _mm512_setzero_si512(), odd = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i quantity = _mm512_loadu_si512((const void*)(q + i));
+        __m512i price = _mm512_loadu_si512((const void*)(p + i));
+        even = _mm512_add_epi64(even, _mm512_mul_epi32(quantity, price));
+        odd = _mm512_add_epi64(odd, _mm512_mul_epi32(_mm512_srli_epi64(quantity, 32), _mm512_srli_epi64(price, 32)));
+    }
+    return (uint64_t)_mm512_reduce_add_epi64(_mm512_add_epi64(even, odd)) + valueScalar(q + i, p + i, n - i);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+// ---------------------------------------------------------------- Kernel selection
+
+struct Kernels {
+    const char* name;
+    void (*lines)(const int32_t* q, const int32_t* p, const int32_t* d, const int32_t* t, size_t n, Cents* out);
+    uint64_t (*value)(const int32_t* q, const int32_t* p, size_t n);
+};
+
+static Kernels pickKernels() {
+#ifdef PRICING_X86
+    const CpuFeatures& cpu = cpuFeatures();
+    if (cpu.avx512f) return {"AVX-512", linesAvx512, valueAvx512};
+    if (cpu.avx2) return {"AVX2", linesScalar, valueAvx2};
+#endif
+    return {"scalar", linesScalar, valueScalar};
+}
+
+static const Kernels& kernels() {
+    static const Kernels chosen = pickKernels();
+    return chosen;
+}
+
+const char* pricingKernelName() {
+    return kernels().name;
+}
+
+// ---------------------------------------------------------------- Batches
+
+size_t firstInvalidLine(const PriceColumns& columns) {
+    for (size_t i = 0; i < columns.lines; i++) {
+        if (!lineValid(columns.quantity[i], columns.unitPrice[i], columns.discount[i], columns.tax[i])) return i;
+    }
+    return columns.lines;
+}
+
+void priceLines(const PriceColumns& columns, Cents* totals, int threads) {
+    const Kernels& kernel = kernels();
+    runSlices(columns.lines, sliceCount(columns.lines, threads, ParallelLines), [&](int, size_t begin, size_t end) {
+        kernel.lines(columns.quantity + begin, columns.unitPrice + begin, columns.discount + begin,
+                     columns.tax + begin, end - begin, totals + begin);
+    });
+}
+
+Cents priceOrders(const PriceColumns& columns, const uint64_t* orderStarts, size_t orders, Cents* orderTotals,
+                  int threads) {
+    const Kernels& kernel = kernels();
+    threads = sliceCount(columns.lines, threads, ParallelLines);
+    std::vector<uint64_t> sums((size_t)threads, 0);
+
+    // Slices are ranges of whole orders. Each prices its lines a block at a time into running sums,
+    // so an order's total is the running sum at its end minus the one at its start: no per-line branch.
+    runSlices(orders, threads, [&](int slice, size_t first, size_t last) {
+        std::vector<Cents> block(BlockLines);
+        std::vector<uint64_t> running(BlockLines + 1); // running[i]: slice total before line b + i
+        size_t order = first;
+        uint64_t sliceSum = 0, orderStart = 0;
+        for (uint64_t b = orderStarts[first], end = orderStarts[last]; b < end; b += BlockLines) {
+            size_t n = (size_t)std::min<uint64_t>(BlockLines, end - b);
+            kernel.lines(columns.quantity + b, columns.unitPrice + b, columns.discount + b, columns.tax + b, n,
+                         block.data());
+            running[0] = sliceSum;
+            for (size_t i = 0; i < n; i++) running[i + 1] = running[i] + (uint64_t)block[i];
+            sliceSum = running[n];
+            for (; order < last && orderStarts[order + 1] <= b + n; order++) {
+                uint64_t orderEnd = running[orderStarts[order + 1] - b];
+                orderTotals[order] = (Cents)(orderEnd - orderStart);
+                orderStart = orderEnd;
+            }
+        }
+        for (; order < last; order++) orderTotals[order] = 0; // Only when the slice has no lines
+        sums[(size_t)slice] = sliceSum;
+    });
+
+    uint64_t total = 0;
+    for (uint64_t sum : sums) total += sum;
+    return (Cents)total;
+}
+
+Cents inventoryValue(const int32_t* quantity, const int32_t* unitPrice, size_t items, int threads) {
+    const Kernels& kernel = kernels();
+    threads = sliceCount(items, threads, ParallelLines);
+    std::vector<uint64_t> sums((size_t)threads, 0);
+    runSlices(items, threads, [&](int slice, size_t begin, size_t end) {
+        sums[(size_t)slice] = kernel.value(quantity + begin, unitPrice + begin, end - begin);
+    });
+    uint64_t total = 0;
+    for (uint64_t sum : sums) total += sum;
+    return (Cents)total;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "money.h"
+
+/*
+This header file defines batch pricing: line totals, order totals and
+inventory valuation over columnar arrays of line items.
+
+Each line is priced in exact integer cents:
+
+    gross    = quantity * unitPrice
+    discount = gross * discount / 10000, rounded half up
+    net      = gross - discount
+    tax      = net * tax / 10000, rounded half up
+    total    = net + tax
+
+Discounts and tax rates are basis points (1250 is 12.5%). Every line
+must satisfy lineValid(): nothing negative, rates of at most 100% and a
+gross of at most MaxLineGross, which keeps every intermediate product
+inside 64 bits. The batch functions do not check; firstInvalidLine()
+finds the first line that breaks the rules.
+
+Line pricing has an AVX-512 kernel and valuation AVX-512 and AVX2
+kernels, chosen at run time, plus scalar fallbacks; every kernel gives
+exactly linePrice() for every line. Large batches are split across
+threads.
+*/
+
+const int32_t MaxBasisPoints = 10000;       // 100%
+const uint64_t MaxLineGross = 1ull << 50;   // quantity * unitPrice of one line, about $11 trillion
+
+// Line items, one per index of every column
+struct PriceColumns {
+    const int32_t* quantity = nullptr;  // Units
+    const int32_t* unitPrice = nullptr; // Cents
+    const int32_t* discount = nullptr;  // Basis points off the gross
+    const int32_t* tax = nullptr;       // Basis points on top of the net
+    size_t lines = 0;
+};
+
+bool lineValid(int32_t quantity, int32_t unitPrice, int32_t discount, int32_t tax);
+size_t firstInvalidLine(const PriceColumns& columns); // columns.lines if every line is valid
+
+// The scalar reference: the total of one valid line
+Cents linePrice(int32_t quantity, int32_t unitPrice, int32_t discount, int32_t tax);
+
+// totals[i] = linePrice of line i. threads: 0 uses every hardware thread.
+void priceLines(const PriceColumns& columns, Cents* totals, int threads = 0);
+
+// Lines are grouped into orders: order o is lines [orderStarts[o], orderStarts[o + 1]), so
+// orderStarts has orders + 1 nondecreasing entries from 0 to columns.lines. Writes the sum of
+// each order's line totals to orderTotals[o] and returns the sum of all of them.
+Cents priceOrders(const PriceColumns& columns, const uint64_t* orderStarts, size_t orders, Cents* orderTotals,
+                  int threads = 0);
+
+// Sum of quantity * unitPrice over every item, before discounts and tax. Unlike line items, either
+// may be negative (returns, credits); every kernel multiplies signed.
+Cents inventoryValue(const int32_t* quantity, const int32_t* unitPrice, size_t items, int threads = 0);
+
+const char* pricingKernelName(); // "AVX-512", "AVX2" or "scalar"
@@ -0,0 +1,116 @@
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "pricing.h"
+
+// Build: g++ -std=c++17 -O2 -pthread pricing_test.cpp pricing.cpp
+//
+// Checks the kernel chosen on this machine against linePrice() and plain signed sums: random and
+// boundary lines, batch lengths that leave a scalar tail, orders with empty ones among them, negative
+// quantities and prices in the valuation, and one and several threads. Exits 1 on any mismatch.
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        std::printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+int main() {
+    std::printf("Kernel: %s\n", pricingKernelName());
+
+    // Hand-worked lines: rounding half up on both the discount and the tax
+    check(linePrice(3, 10, 0, 0) == 30, "3 x 0.10");
+    check(linePrice(1, 10001, 5000, 0) == 5000, "half of 100.01 rounds the discount up");
+    check(linePrice(1, 1000, 0, 825) == 1083, "8.25% tax on 10.00 is 0.825, rounded to 0.83");
+    check(linePrice(7, 199, MaxBasisPoints, MaxBasisPoints) == 0, "a 100% discount leaves nothing to tax");
+    check(!lineValid(-1, 100, 0, 0) && !lineValid(1, 100, 10001, 0) && !lineValid(1 << 30, 1 << 30, 0, 0),
+          "lineValid rejects negatives, rates above 100% and a gross above MaxLineGross");
+
+    std::mt19937_64 random(7);
+    const size_t n = 1000003; // Not a multiple of any vector width
+    std::vector<int32_t> q(n), p(n), d(n), t(n);
+    for (size_t i = 0; i < n; i++) {
+        switch (random() % 3) {
+        case 0: // Everyday lines
+            q[i] = (int32_t)(random() % 1000);
+            p[i] = (int32_t)(random() % 100000);
+            break;
+        case 1: // Gross at or just under MaxLineGross
+            q[i] = 1 + (int32_t)(random() % INT32_MAX);
+            p[i] = (int32_t)std::min<uint64_t>(INT32_MAX, MaxLineGross / (uint64_t)q[i]) - (int32_t)(random() % 3);
+            if (p[i] < 0) p[i] = 0;
+            break;
+        default: // Large prices
+            q[i] = (int32_t)(random() % 50000);
+            p[i] = (int32_t)(random() % INT32_MAX);
+            while ((uint64_t)q[i] * (uint64_t)p[i] > MaxLineGross) q[i] /= 2;
+            break;
+        }
+        d[i] = random() % 4 ? (int32_t)(random() % (MaxBasisPoints + 1)) : (random() % 2 ? MaxBasisPoints : 0);
+        t[i] = random() % 4 ? (int32_t)(random() % (MaxBasisPoints + 1)) : (random() % 2 ? MaxBasisPoints : 5000);
+    }
+    PriceColumns columns{q.data(), p.data(), d.data(), t.data(), n};
+    check(firstInvalidLine(columns) == n, "generated lines are valid");
+
+    std::vector<Cents> expected(n);
+    for (size_t i = 0; i < n; i++) expected[i] = linePrice(q[i], p[i], d[i], t[i]);
+
+    // Orders of 0 to 6 lines, with trailing empty orders
+    std::vector<uint64_t> starts{0};
+    while (starts.back() < n) starts.push_back(std::min<uint64_t>(n, starts.back() + random() % 7));
+    starts.push_back(n);
+    size_t orders = starts.size() - 1;
+    std::vector<Cents> expectedOrders(orders);
+    uint64_t expectedGrand = 0;
+    for (size_t o = 0; o < orders; o++) {
+        uint64_t sum = 0;
+        for (uint64_t i = starts[o]; i < starts[o + 1]; i++) sum += (uint64_t)expected[i];
+        expectedOrders[o] = (Cents)sum;
+        expectedGrand += sum;
+    }
+
+    // Valuation with returns and credits: negative quantities and prices
+    std::vector<int32_t> stock(n), cost(n);
+    uint64_t expectedValue = 0;
+    for (size_t i = 0; i < n; i++) {
+        stock[i] = (int32_t)(random() % 2000001) - 1000000;
+        cost[i] = random() % 8 ? (int32_t)(random() % 1000000) : -(int32_t)(random() % 1000000);
+        expectedValue += (uint64_t)((int64_t)stock[i] * cost[i]);
+    }
+    int32_t fewStock[64], fewCost[64];
+    for (int i = 0; i < 64; i++) {
+        fewStock[i] = i == 3 || i == 40 ? -5 : 1;
+        fewCost[i] = 100;
+    }
+    check(inventoryValue(fewStock, fewCost, 64) == 5200, "64 items, two of them -5");
+
+    for (int threads : {1, 3}) {
+        std::vector<Cents> totals(n);
+        priceLines(columns, totals.data(), threads);
+        check(totals == expected, "priceLines matches linePrice");
+
+        std::vector<Cents> orderTotals(orders, -1);
+        Cents grand = priceOrders(columns, starts.data(), orders, orderTotals.data(), threads);
+        check(orderTotals == expectedOrders, "priceOrders order totals");
+        check((uint64_t)grand == expectedGrand, "priceOrders grand total");
+
+        check((uint64_t)inventoryValue(stock.data(), cost.data(), n, threads) == expectedValue,
+              "inventoryValue with negative quantities and prices");
+        for (size_t length = 0; length < 40; length++) { // Every tail length of the vector loops
+            uint64_t sum = 0;
+            for (size_t i = 0; i < length; i++) sum += (uint64_t)((int64_t)stock[i] * cost[i]);
+            check((uint64_t)inventoryValue(stock.data(), cost.data(), length, threads) == sum, "short valuation");
+        }
+    }
+
+    uint64_t none = 0;
+    Cents unused;
+    check(priceOrders(PriceColumns(), &none, 0, &unused) == 0, "no orders");
+
+    std::printf(failures ? "%d checks failed\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
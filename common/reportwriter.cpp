@@ -0,0 +1,329 @@
+#include "reportwriter.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+/*
+This source file implements the ReportWriter class declared in
+reportwriter.h.
+*/
+
+// ---------------------------------------------------------------- Formats
+
+bool parseReportFormat(std::string_view name, ReportFormat& format) {
+    if (name == "csv") format = ReportFormat::Csv;
+    else if (name == "tsv") format = ReportFormat::Tsv;
+    else if (name == "jsonl") format = ReportFormat::JsonLines;
+    else if (name == "text") format = ReportFormat::Aligned;
+    else return false;
+    return true;
+}
+
+// ---------------------------------------------------------------- Output
+
+// Writes every byte, retrying short writes; false on error
+static bool writeAll(int fd, const char* data, size_t length, size_t& calls) {
+    while (length > 0) {
+#ifdef _WIN32
+        int n = _write(fd, data, (unsigned)std::min(length, (size_t)1 << 30));
+#else
+        ssize_t n = ::write(fd, data, length);
+#endif
+        calls++;
+        if (n <= 0) return false;
+        data += n;
+        length -= (size_t)n;
+    }
+    return true;
+}
+
+ReportWriter::ReportWriter(size_t bufferBytes) {
+    buffer.resize(std::max(bufferBytes, (size_t)256)); // Room for any single number and its padding
+}
+
+ReportWriter::~ReportWriter() {
+    close();
+}
+
+bool ReportWriter::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+    ownsFd = fd >= 0;
+    failed = fd < 0;
+    return fd >= 0;
+}
+
+void ReportWriter::attach(int descriptor) {
+    close();
+    fd = descriptor;
+    ownsFd = false;
+    failed = false;
+}
+
+void ReportWriter::writeOut(const char* extra, size_t extraLength) {
+    if (!failed && fd >= 0) {
+#ifndef _WIN32
+        if (used > 0 && extraLength > 0) {
+            // Both pieces in one call; a short write finishes with plain writes
+            iovec pieces[2] = {{buffer.data(), used}, {(void*)extra, extraLength}};
+            ssize_t n = ::writev(fd, pieces, 2);
+            writes++;
+            if (n < 0) {
+                failed = true;
+            } else if ((size_t)n < used) {
+                failed = !writeAll(fd, buffer.data() + n, used - (size_t)n, writes) ||
+                         !writeAll(fd, extra, extraLength, writes);
+            } else {
+                failed = !writeAll(fd, extra + (n - used), extraLength - ((size_t)n - used), writes);
+            }
+            used = 0;
+            return;
+        }
+#endif
+        failed = !writeAll(fd, buffer.data(), used, writes) || !writeAll(fd, extra, extraLength, writes);
+    }
+    used = 0;
+}
+
+void ReportWriter::append(const char* text, size_t length) {
+    if (length <= buffer.size() - used) {
+        std::memcpy(buffer.data() + used, text, length);
+        used += length;
+    } else if (length < buffer.size()) {
+        writeOut(nullptr, 0);
+        std::memcpy(buffer.data(), text, length);
+        used = length;
+    } else {
+        writeOut(text, length); // Too big to buffer: goes out with whatever is pending
+    }
+}
+
+bool ReportWriter::flush() {
+    if (used > 0) writeOut(nullptr, 0);
+    return !failed;
+}
+
+bool ReportWriter::close() {
+    bool result = flush();
+    if (ownsFd && fd >= 0) {
+#ifdef _WIN32
+        result = _close(fd) == 0 && result;
+#else
+        result = ::close(fd) == 0 && result;
+#endif
+    }
+    fd = -1;
+    ownsFd = false;
+    return result;
+}
+
+bool ReportWriter::ok() const {
+    return !failed;
+}
+
+size_t ReportWriter::writeCalls() const {
+    return writes;
+}
+
+// ---------------------------------------------------------------- Rows
+
+static std::string jsonKey(const std::string& name, bool first) {
+    std::string key = first ? "{\"" : ",\"";
+    for (char c : name) {
+        if (c == '"' || c == '\\') key += '\\';
+        key += c;
+    }
+    return key + "\":";
+}
+
+void ReportWriter::begin(ReportFormat reportFormat, const std::vector<ReportColumn>& reportColumns) {
+    format = reportFormat;
+    columns = reportColumns;
+    prefixes.clear();
+    for (size_t i = 0; i < columns.size(); i++) {
+        columns[i].width = std::max(columns[i].width, (int)columns[i].name.size());
+        switch (format) {
+        case ReportFormat::Csv: prefixes.push_back(i == 0 ? "" : ","); break;
+        case ReportFormat::Tsv: prefixes.push_back(i == 0 ? "" : "\t"); break;
+        case ReportFormat::JsonLines: prefixes.push_back(jsonKey(columns[i].name, i == 0)); break;
+        case ReportFormat::Aligned: prefixes.push_back(i == 0 ? "" : "  "); break;
+        }
+    }
+    column = 0;
+
+    if (format == ReportFormat::JsonLines) return; // Every line names its own keys
+    for (const ReportColumn& c : columns) {
+        if (format == ReportFormat::Aligned && c.numeric) {
+            beginField();
+            pad(c.name.size(), true, c.name.data());
+        } else {
+            text(c.name);
+        }
+    }
+    endRow();
+}
+
+void ReportWriter::beginField() {
+    if (column < prefixes.size()) append(prefixes[column].data(), prefixes[column].size());
+    column++;
+}
+
+void ReportWriter::pad(size_t length, bool number, const char* text) {
+    static const char spaces[] = "                                                                ";
+    size_t width = column <= columns.size() ? (size_t)columns[column - 1].width : 0;
+    bool last = column >= columns.size();
+    size_t gap = width > length && (number || !last) ? width - length : 0; // Text in the last column is not padded
+    if (!number) append(text, length);
+    for (size_t n = gap; n > 0;) {
+        size_t step = std::min(n, sizeof(spaces) - 1);
+        append(spaces, step);
+        n -= step;
+    }
+    if (number) append(text, length);
+}
+
+void ReportWriter::text(std::string_view value) {
+    beginField();
+    const char* p = value.data();
+    const char* end = p + value.size();
+    switch (format) {
+    case ReportFormat::Csv:
+        if (std::none_of(p, end, [](char c) { return c == ',' || c == '"' || c == '\r' || c == '\n'; })) {
+            append(p, value.size());
+        } else {
+            // Quoted, with every quote doubled
+            append("\"", 1);
+            for (const char* q; (q = (const char*)std::memchr(p, '"', (size_t)(end - p))) != nullptr; p = q + 1) {
+                append(p, (size_t)(q - p) + 1);
+                append("\"", 1);
+            }
+            append(p, (size_t)(end - p));
+            append("\"", 1);
+        }
+        break;
+    case ReportFormat::Tsv:
+        for (const char* q = p; q < end; q++) {
+            if (*q == '\t' || *q == '\r' || *q == '\n') {
+                append(p, (size_t)(q - p));
+                append(" ", 1);
+                p = q + 1;
+            }
+        }
+        append(p, (size_t)(end - p));
+        break;
+    case ReportFormat::JsonLines:
+        append("\"", 1);
+        for (const char* q = p; q < end; q++) {
+            unsigned char c = (unsigned char)*q;
+            if (c != '"' && c != '\\' && c >= 0x20) continue;
+            append(p, (size_t)(q - p));
+            char escape[7] = {'\\', (char)c, 0};
+            size_t length = 2;
+            if (c == '\n') escape[1] = 'n';
+            else if (c == '\r') escape[1] = 'r';
+            else if (c == '\t') escape[1] = 't';
+            else if (c < 0x20) {
+                static const char hex[] = "0123456789abcdef";
+                std::memcpy(escape + 1, "u00", 3);
+                escape[4] = hex[c >> 4];
+                escape[5] = hex[c & 15];
+                length = 6;
+            }
+            append(escape, length);
+            p = q + 1;
+        }
+        append(p, (size_t)(end - p));
+        append("\"", 1);
+        break;
+    case ReportFormat::Aligned:
+        if (value.find_first_of("\t\r\n") != std::string_view::npos) {
+            std::string line(value); // Rare: line breaks would wreck the layout
+            std::replace_if(line.begin(), line.end(), [](char c) { return c == '\t' || c == '\r' || c == '\n'; }, ' ');
+            pad(line.size(), false, line.data());
+        } else {
+            pad(value.size(), false, p);
+        }
+        break;
+    }
+}
+
+void ReportWriter::integer(long long value) {
+    char digits[24];
+    size_t length = (size_t)(std::to_chars(digits, digits + sizeof(digits), value).ptr - digits);
+    beginField();
+    if (format == ReportFormat::Aligned) pad(length, true, digits);
+    else append(digits, length);
+}
+
+void ReportWriter::number(double value, int decimals) {
+    if (format == ReportFormat::JsonLines && !std::isfinite(value)) {
+        beginField();
+        append("null", 4); // JSON has no NaN or infinity
+        return;
+    }
+    char digits[64];
+    if (decimals < 0 && std::fabs(value) < 1e9) {
+        // Most report values have at most three decimals (grades, scores). Integer formatting gives
+        // them the same digits as the shortest form several times faster, and round numbers such as
+        // 100000 stay in plain notation instead of becoming 1e+05
+        long long thousandths = std::llround(value * 1000);
+        if ((double)thousandths / 1000 == value && !(thousandths == 0 && std::signbit(value))) {
+            unsigned long long magnitude = (unsigned long long)(thousandths < 0 ? -thousandths : thousandths);
+            char* p = digits;
+            if (thousandths < 0) *p++ = '-';
+            p = std::to_chars(p, digits + sizeof(digits), magnitude / 1000).ptr;
+            unsigned fraction = (unsigned)(magnitude % 1000);
+            if (fraction != 0) {
+                p[0] = '.';
+                p[1] = (char)('0' + fraction / 100);
+                p[2] = (char)('0' + fraction / 10 % 10);
+                p[3] = (char)('0' + fraction % 10);
+                p += 4;
+                while (p[-1] == '0') p--; // Trailing zeros
+            }
+            beginField();
+            if (format == ReportFormat::Aligned) pad((size_t)(p - digits), true, digits);
+            else append(digits, (size_t)(p - digits));
+            return;
+        }
+    }
+    std::to_chars_result result = decimals < 0
+        ? std::to_chars(digits, digits + sizeof(digits), value)
+        : std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, std::min(decimals, 17));
+    if (result.ec != std::errc()) result = std::to_chars(digits, digits + sizeof(digits), value); // Huge fixed values
+    size_t length = (size_t)(result.ptr - digits);
+    beginField();
+    if (format == ReportFormat::Aligned) pad(length, true, digits);
+    else append(digits, length);
+}
+
+void ReportWriter::yesNo(bool value) {
+    if (format == ReportFormat::JsonLines) {
+        beginField();
+        if (value) append("true", 4);
+        else append("false", 5);
+        return;
+    }
+    text(value ? "Yes" : "No");
+}
+
+void ReportWriter::endRow() {
+    if (format == ReportFormat::JsonLines) append("}\n", 2);
+    else append("\n", 1);
+    column = 0;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+This header file defines ReportWriter, a buffered writer for large
+tabular reports: CSV, TSV, JSON Lines or aligned text.
+
+Rows are written field by field into one reusable buffer (1 MB by
+default). Numbers are formatted with std::to_chars, so nothing goes
+through iostreams or allocates per row. The buffer is written out with a
+single write() call whenever it fills, and once more on flush() or
+close(). Text longer than the buffer is passed straight to the file,
+together with whatever is already buffered (one writev() on POSIX).
+
+    ReportWriter out;
+    out.open("report.csv");
+    out.begin(ReportFormat::Csv, {{"name"}, {"seconds"}});
+    out.text("Reading");
+    out.integer(5400);
+    out.endRow();
+    out.close();
+
+Text is escaped for the format: CSV quotes fields that contain commas,
+quotes or line breaks, TSV and aligned text turn tabs and line breaks
+into spaces, and JSON escapes quotes, backslashes and control
+characters. Aligned text pads each field to its column width (numbers
+on the right) and never truncates.
+*/
+
+enum class ReportFormat { Csv, Tsv, JsonLines, Aligned };
+
+// "csv", "tsv", "jsonl" or "text"; false for anything else
+bool parseReportFormat(std::string_view name, ReportFormat& format);
+
+struct ReportColumn {
+    std::string name;
+    int width = 0;        // Aligned text only: minimum width (the name's length if larger)
+    bool numeric = false; // Aligned text only: right-align the header like the numbers below it
+};
+
+class ReportWriter {
+private:
+    int fd = -1;                 // Destination descriptor
+    bool ownsFd = false;         // True if open() created it (closed by close())
+    bool failed = false;         // A write failed; later output is dropped
+    std::vector<char> buffer;    // Pending output
+    size_t used = 0;             // Bytes of buffer in use
+    size_t writes = 0;           // write()/writev() calls made so far
+    ReportFormat format = ReportFormat::Csv;
+    std::vector<ReportColumn> columns;
+    std::vector<std::string> prefixes; // Text before each field: separator, JSON key or padding gap
+    size_t column = 0;           // Next field of the current row
+
+    void append(const char* text, size_t length);              // Copies into the buffer, writing out as needed
+    void writeOut(const char* extra, size_t extraLength);       // Buffer plus extra bytes, then empties the buffer
+    void beginField();                                          // Writes the prefix of the next field
+    void pad(size_t length, bool number, const char* text);     // Aligned text: field with padding
+
+public:
+    static const size_t DefaultBufferBytes = 1 << 20;
+
+    explicit ReportWriter(size_t bufferBytes = DefaultBufferBytes);
+    ~ReportWriter();                                            // Flushes, and closes a file opened here
+    ReportWriter(const ReportWriter&) = delete;
+    ReportWriter& operator=(const ReportWriter&) = delete;
+
+    bool open(const std::string& path); // Creates or truncates a file; false if it cannot be opened
+    void attach(int fd);                // Writes to an existing descriptor (1 = stdout), which stays open
+
+    // Starts a report: remembers the columns and writes the header line (none for JSON Lines)
+    void begin(ReportFormat format, const std::vector<ReportColumn>& columns);
+
+    // One call per column, in order, then endRow()
+    void text(std::string_view value);
+    void integer(long long value);
+    void number(double value, int decimals = -1); // Shortest round-trip form, or fixed decimals
+    void yesNo(bool value);                       // "Yes"/"No", or true/false in JSON
+    void endRow();
+
+    bool flush();               // Writes out everything buffered; false if any write has failed
+    bool close();               // Flushes and closes a file opened with open()
+    bool ok() const;            // False once a write has failed
+    size_t writeCalls() const;  // write()/writev() calls so far
+};
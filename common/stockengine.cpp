@@ -0,0 +1,121 @@
+#include "stockengine.h"
+#include <utility>
+
+/*
+This source file implements the lock-free StockEngine counters and the
+Reservation holder declared in stockengine.h.
+*/
+
+// ---------------------------------------------------------------- StockEngine
+
+StockEngine::StockEngine(size_t skus) : slots(new StockSlot[skus]), count(skus) {
+}
+
+size_t StockEngine::size() const {
+    return count;
+}
+
+bool StockEngine::restock(uint32_t sku, int64_t quantity) {
+    if (sku >= count || quantity < 0) return false;
+    slots[sku].available.fetch_add(quantity, std::memory_order_relaxed);
+    return true;
+}
+
+bool StockEngine::reserve(uint32_t sku, int64_t quantity) {
+    if (sku >= count || quantity < 0) return false;
+    StockSlot& slot = slots[sku];
+    int64_t current = slot.available.load(std::memory_order_relaxed);
+    do {
+        if (current < quantity) return false; // Checked against the value the swap replaces
+    } while (!slot.available.compare_exchange_weak(current, current - quantity, std::memory_order_acq_rel,
+                                                   std::memory_order_relaxed));
+    slot.reserved.fetch_add(quantity, std::memory_order_relaxed);
+    return true;
+}
+
+bool StockEngine::commit(uint32_t sku, int64_t quantity) {
+    if (sku >= count || quantity < 0) return false;
+    slots[sku].reserved.fetch_sub(quantity, std::memory_order_relaxed);
+    return true;
+}
+
+bool StockEngine::release(uint32_t sku, int64_t quantity) {
+    if (sku >= count || quantity < 0) return false;
+    // Back to available before it leaves reserved, so on-hand is never seen short
+    slots[sku].available.fetch_add(quantity, std::memory_order_relaxed);
+    slots[sku].reserved.fetch_sub(quantity, std::memory_order_relaxed);
+    return true;
+}
+
+bool StockEngine::reserveAll(const StockLine* lines, size_t lineCount) {
+    for (size_t i = 0; i < lineCount; i++) {
+        if (!reserve(lines[i].sku, lines[i].quantity)) {
+            releaseAll(lines, i); // Give back the lines already taken
+            return false;
+        }
+    }
+    return true;
+}
+
+void StockEngine::commitAll(const StockLine* lines, size_t lineCount) {
+    for (size_t i = 0; i < lineCount; i++) commit(lines[i].sku, lines[i].quantity);
+}
+
+void StockEngine::releaseAll(const StockLine* lines, size_t lineCount) {
+    for (size_t i = 0; i < lineCount; i++) release(lines[i].sku, lines[i].quantity);
+}
+
+int64_t StockEngine::available(uint32_t sku) const {
+    return sku < count ? slots[sku].available.load(std::memory_order_relaxed) : 0;
+}
+
+int64_t StockEngine::reserved(uint32_t sku) const {
+    return sku < count ? slots[sku].reserved.load(std::memory_order_relaxed) : 0;
+}
+
+int64_t StockEngine::onHand(uint32_t sku) const {
+    return available(sku) + reserved(sku);
+}
+
+// ---------------------------------------------------------------- Reservation
+
+Reservation::Reservation(StockEngine& stock, std::vector<StockLine> orderLines)
+    : engine(&stock), lines(std::move(orderLines)) {
+    held = engine->reserveAll(lines.data(), lines.size());
+}
+
+Reservation::~Reservation() {
+    release();
+}
+
+Reservation::Reservation(Reservation&& other) noexcept
+    : engine(other.engine), lines(std::move(other.lines)), held(other.held) {
+    other.held = false;
+}
+
+Reservation& Reservation::operator=(Reservation&& other) noexcept {
+    if (this != &other) {
+        release();
+        engine = other.engine;
+        lines = std::move(other.lines);
+        held = other.held;
+        other.held = false;
+    }
+    return *this;
+}
+
+bool Reservation::ok() const {
+    return held;
+}
+
+void Reservation::commit() {
+    if (!held) return;
+    engine->commitAll(lines.data(), lines.size());
+    held = false;
+}
+
+void Reservation::release() {
+    if (!held) return;
+    engine->releaseAll(lines.data(), lines.size());
+    held = false;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/*
+This header file defines StockEngine, the stock counts of many SKUs
+updated by any number of order threads, and Reservation, an order's hold
+on stock until it is confirmed or dropped.
+
+Each SKU's counters sit alone on a 64-byte line, so threads working on
+different SKUs never contend for a cache line. A SKU's stock is split
+into available (free to reserve) and reserved (held by orders):
+
+    reserve  available -> reserved   fails, changing nothing, if too little is available
+    commit   reserved  -> gone       the order shipped
+    release  reserved  -> available  the order was cancelled
+    restock  new stock -> available
+
+reserve() is a compare-and-swap loop that checks the quantity against
+the exact value it replaces, so available never goes below zero however
+many threads reserve at once. The stock on hand is available + reserved.
+
+reserveAll() reserves several lines for one order: all of them or none.
+It reserves line by line and gives back what it took as soon as one line
+fails, so another order may briefly see (and fail on) stock that ends up
+released; it never sees stock that was not there.
+*/
+
+struct StockLine {
+    uint32_t sku;
+    int64_t quantity;
+};
+
+// One SKU's counters, alone on its cache line
+struct alignas(64) StockSlot {
+    std::atomic<int64_t> available{0};
+    std::atomic<int64_t> reserved{0};
+};
+
+class StockEngine {
+private:
+    std::unique_ptr<StockSlot[]> slots;
+    size_t count = 0;
+
+public:
+    explicit StockEngine(size_t skus);
+
+    size_t size() const;
+
+    // False, changing nothing, for an unknown SKU, a negative quantity or (reserve) too little stock
+    bool restock(uint32_t sku, int64_t quantity);
+    bool reserve(uint32_t sku, int64_t quantity);
+    bool commit(uint32_t sku, int64_t quantity);  // Only for a quantity this caller reserved
+    bool release(uint32_t sku, int64_t quantity); // Only for a quantity this caller reserved
+
+    // Reserves every line or none (see above); lines may repeat a SKU
+    bool reserveAll(const StockLine* lines, size_t lineCount);
+    void commitAll(const StockLine* lines, size_t lineCount);
+    void releaseAll(const StockLine* lines, size_t lineCount);
+
+    int64_t available(uint32_t sku) const; // 0 for an unknown SKU
+    int64_t reserved(uint32_t sku) const;
+    int64_t onHand(uint32_t sku) const;    // available + reserved; exact only while the SKU is idle
+};
+
+// Stock held for one order. Dropping a Reservation that was not committed releases the stock, so an
+// order that fails halfway (or throws) cannot leak it.
+class Reservation {
+private:
+    StockEngine* engine = nullptr;
+    std::vector<StockLine> lines;
+    bool held = false;
+
+public:
+    Reservation() = default;
+    Reservation(StockEngine& engine, std::vector<StockLine> lines); // Tries to reserve every line
+    ~Reservation();
+    Reservation(Reservation&& other) noexcept;
+    Reservation& operator=(Reservation&& other) noexcept;
+    Reservation(const Reservation&) = delete;
+    Reservation& operator=(const Reservation&) = delete;
+
+    bool ok() const;  // True while the stock is held
+    void commit();    // The order is confirmed: the stock leaves for good
+    void release();   // The order is dropped: the stock is available again
+};
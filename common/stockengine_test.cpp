@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+#include "stockengine.h"
+
+// Build: g++ -std=c++17 -O2 -pthread stockengine_test.cpp stockengine.cpp
+//
+// Stress test for StockEngine: order threads reserve multi-line orders (through Reservation) and
+// commit or drop them while restock threads add stock and an observer watches every counter. Stock
+// must never be seen below zero, and afterwards every SKU must hold exactly what was restocked minus
+// what was committed, with nothing left reserved. Exits 1 on any failure.
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        std::printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+const uint32_t Skus = 64;
+
+int main() {
+    // All-or-nothing orders
+    StockEngine small(4);
+    small.restock(0, 5);
+    small.restock(1, 1);
+    check(!small.reserve(4, 1) && !small.restock(0, -1) && !small.reserve(0, 6), "bad calls change nothing");
+    StockLine tooMuch[] = {{0, 3}, {1, 2}};
+    check(!small.reserveAll(tooMuch, 2) && small.available(0) == 5 && small.reserved(0) == 0,
+          "a failed reserveAll gives back the lines it took");
+    {
+        Reservation held(small, {{0, 2}, {0, 2}, {1, 1}});
+        check(held.ok() && small.available(0) == 1 && small.reserved(0) == 4, "repeated SKUs in one order");
+    }
+    check(small.available(0) == 5 && small.reserved(0) == 0, "dropping a Reservation releases it");
+
+    // Stress: orders, restocks and an observer at once
+    StockEngine engine(Skus);
+    int orderThreads = (int)std::max(4u, std::thread::hardware_concurrency());
+    std::vector<std::vector<int64_t>> committed((size_t)orderThreads, std::vector<int64_t>(Skus, 0));
+    std::vector<std::vector<int64_t>> restocked(2, std::vector<int64_t>(Skus, 0));
+    std::atomic<bool> done{false};
+    std::atomic<long> negative{0}, placed{0}, refused{0};
+
+    std::thread observer([&]() {
+        while (!done.load()) {
+            for (uint32_t s = 0; s < Skus; s++) {
+                if (engine.available(s) < 0 || engine.reserved(s) < 0) negative++;
+            }
+        }
+    });
+    std::vector<std::thread> threads;
+    for (int r = 0; r < 2; r++) {
+        threads.emplace_back([&, r]() {
+            std::mt19937 random(1000 + r);
+            for (int i = 0; i < 100000; i++) {
+                uint32_t sku = random() % 2 ? random() % 8 : random() % Skus; // Hot SKUs sell most
+                int64_t quantity = 1 + random() % 24;
+                if (engine.restock(sku, quantity)) restocked[(size_t)r][sku] += quantity;
+            }
+        });
+    }
+    for (int t = 0; t < orderThreads; t++) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 random(t + 1);
+            for (int i = 0; i < 100000; i++) {
+                std::vector<StockLine> lines(1 + random() % 4);
+                for (StockLine& line : lines) line = {(uint32_t)(random() % 8 ? random() % 8 : random() % Skus),
+                                                      (int64_t)(1 + random() % 6)}; // Mostly hot SKUs
+                Reservation order(engine, lines);
+                if (!order.ok()) {
+                    refused++;
+                    continue;
+                }
+                placed++;
+                if (random() % 4 == 0) continue; // Dropped: the destructor releases it
+                order.commit();
+                for (const StockLine& line : lines) committed[(size_t)t][line.sku] += line.quantity;
+            }
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    done = true;
+    observer.join();
+
+    check(negative.load() == 0, "no counter ever seen below zero");
+    check(placed.load() > 0 && refused.load() > 0, "the mix both placed and refused orders");
+    bool balanced = true;
+    for (uint32_t s = 0; s < Skus; s++) {
+        int64_t expected = restocked[0][s] + restocked[1][s];
+        for (const auto& c : committed) expected -= c[s];
+        balanced = balanced && engine.available(s) == expected && engine.reserved(s) == 0;
+    }
+    check(balanced, "every SKU holds restocked minus committed, nothing left reserved");
+    std::printf("%ld orders placed, %ld refused\n", placed.load(), refused.load());
+
+    std::printf(failures ? "%d checks failed\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+#include "crc32c.h"
+#include <cstring>
+#include "../common/cpu.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CRC32C_X86 1
+#include <nmmintrin.h>
+#endif
+
+/* ── Portable Slicing-by-8 ───────────────────────────────── */
+
+namespace {
+
+struct Tables {
+    std::uint32_t t[8][256];  // t[k][b]: CRC of byte b followed by k zero bytes
+    Tables() {
+        const std::uint32_t poly = 0x82F63B78u;  // Reflected Castagnoli polynomial
+        for (std::uint32_t b = 0; b < 256; b++) {
+            std::uint32_t c = b;
+            for (int k = 0; k < 8; k++) c = (c >> 1) ^ (poly & (0u - (c & 1u)));
+            t[0][b] = c;
+        }
+        for (int k = 1; k < 8; k++) {
+            for (int b = 0; b < 256; b++) t[k][b] = (t[k - 1][b] >> 8) ^ t[0][t[k - 1][b] & 0xff];
+        }
+    }
+};
+
+const Tables& tables() {
+    static const Tables instance;  // Built once on first use
+    return instance;
+}
+
+}  // namespace
+
+std::uint32_t crc32cPortable(const void* data, std::size_t length, std::uint32_t crc) {
+    const std::uint32_t (*t)[256] = tables().t;
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    while (length >= 8) {
+        std::uint32_t lo, hi;
+        std::memcpy(&lo, p, 4);      // Little-endian load of the next eight bytes
+        std::memcpy(&hi, p + 4, 4);
+        lo ^= crc;
+        crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+        p += 8;
+        length -= 8;
+    }
+    while (length--) crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xff];  // Tail bytes
+    return ~crc;
+}
+
+/* ── SSE4.2 crc32 Instruction ────────────────────────────── */
+
+#ifdef CRC32C_X86
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("sse4.2")))
+#endif
+static std::uint32_t crc32cSse42(const void* data, std::size_t length, std::uint32_t crc) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    std::uint64_t c = ~crc;
+    while (length >= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, p, 8);
+        c = _mm_crc32_u64(c, word);  // Eight bytes per instruction
+        p += 8;
+        length -= 8;
+    }
+    std::uint32_t c32 = (std::uint32_t)c;
+    while (length--) c32 = _mm_crc32_u8(c32, *p++);
+    return ~c32;
+}
+
+#endif
+
+bool crc32cHardware() {
+#ifdef CRC32C_X86
+    return cpuFeatures().sse42;
+#else
+    return false;
+#endif
+}
+
+std::uint32_t crc32c(const void* data, std::size_t length, std::uint32_t crc) {
+#ifdef CRC32C_X86
+    if (crc32cHardware()) return crc32cSse42(data, length, crc);
+#endif
+    return crc32cPortable(data, length, crc);
+}
@@ -0,0 +1,15 @@
+#pragma once
+/*
+ * crc32c.h ― CRC-32C (Castagnoli) checksums for the on-disk session store.
+ * On x86-64 CPUs with SSE4.2 the checksum runs on the crc32 instruction,
+ * eight bytes per step; everywhere else it falls back to a portable
+ * slicing-by-8 table implementation. The choice is made once at runtime,
+ * so the same binary works on older machines.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+std::uint32_t crc32c(const void* data, std::size_t length, std::uint32_t crc = 0); // Extends crc over data
+std::uint32_t crc32cPortable(const void* data, std::size_t length, std::uint32_t crc = 0); // Table-only version
+bool crc32cHardware(); // Returns true if the SSE4.2 instruction path is in use
@@ -0,0 +1,171 @@
+#include "executor.h"
+#include <chrono>
+
+// Identifies the worker (if any) running on the current thread
+static thread_local const Executor* currentExecutor = nullptr;
+static thread_local int currentWorker = -1;
+
+/* ── Construction ────────────────────────────────────────── */
+
+Executor::Executor(int threadCount) : queued(0), nextWorker(0), stopping(false) {
+    if (threadCount <= 0) {
+        int hardware = (int)std::thread::hardware_concurrency();
+        threadCount = hardware > 1 ? hardware - 1 : 1;  // Leave a core for the render thread
+    }
+    for (int i = 0; i < threadCount; i++) {
+        workers.push_back(std::unique_ptr<Worker>(new Worker));
+    }
+    for (int i = 0; i < threadCount; i++) {
+        threads.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+Executor::~Executor() {
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping = true;  // Workers drain their queues and exit
+    }
+    wake.notify_all();
+    for (std::thread& t : threads) t.join();
+}
+
+/* ── Queues ──────────────────────────────────────────────── */
+
+void Executor::enqueue(Job job, Priority priority) {
+    int target;
+    if (currentExecutor == this) {
+        target = currentWorker;  // Jobs spawned by a worker stay local (cache-warm, stealable)
+    } else {
+        target = (int)(nextWorker++ % workers.size());  // Outside submissions are spread round-robin
+    }
+    {
+        std::lock_guard<std::mutex> guard(workers[target]->lock);
+        workers[target]->jobs[priority].push_back(std::move(job));
+    }
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        queued++;
+    }
+    wake.notify_one();
+}
+
+bool Executor::takeJob(int self, Job& job) {
+    int n = (int)workers.size();
+    for (int priority = High; priority <= Low; priority++) {
+        {
+            Worker& own = *workers[self];
+            std::lock_guard<std::mutex> guard(own.lock);
+            if (!own.jobs[priority].empty()) {
+                job = std::move(own.jobs[priority].back());  // Newest own job first
+                own.jobs[priority].pop_back();
+                queued--;
+                return true;
+            }
+        }
+        for (int k = 1; k < n; k++) {
+            Worker& victim = *workers[(self + k) % n];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.jobs[priority].empty()) {
+                job = std::move(victim.jobs[priority].front());  // Steal the oldest job
+                victim.jobs[priority].pop_front();
+                queued--;
+                return true;
+            }
+        }
+        // Nothing at this priority anywhere: only then look at the next lower class
+    }
+    return false;
+}
+
+void Executor::workerLoop(int self) {
+    currentExecutor = this;
+    currentWorker = self;
+    while (true) {
+        Job job;
+        if (takeJob(self, job)) {
+            job();
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(sleepLock);
+        wake.wait(guard, [this]() { return stopping || queued > 0; });
+        if (stopping && queued == 0) return;  // Shut down once the queues are empty
+    }
+}
+
+/* ── Submission ──────────────────────────────────────────── */
+
+void Executor::post(Job job, Job onComplete, Priority priority) {
+    enqueue([this, job, onComplete]() {
+        job();
+        if (onComplete) {
+            std::lock_guard<std::mutex> guard(completionLock);
+            completions.push_back(onComplete);  // Delivered on the GUI thread
+        }
+    }, priority);
+}
+
+void Executor::parallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+                           const std::function<void(std::size_t, std::size_t)>& body, Priority priority) {
+    if (end <= begin) return;
+    if (grain == 0) grain = 1;
+    std::size_t chunks = (end - begin + grain - 1) / grain;
+    if (chunks == 1) {
+        body(begin, end);  // Too small to be worth sharing
+        return;
+    }
+
+    struct State {
+        std::atomic<std::size_t> next{0};  // Next unclaimed chunk
+        std::atomic<std::size_t> done{0};  // Chunks finished
+        std::mutex lock;
+        std::condition_variable finished;
+    };
+    auto state = std::make_shared<State>();
+    const auto* bodyPtr = &body;
+    // Claims chunks until none are left; late helpers find nothing and never touch body
+    auto runChunks = [state, bodyPtr, begin, end, grain, chunks]() {
+        while (true) {
+            std::size_t c = state->next++;
+            if (c >= chunks) return;
+            std::size_t from = begin + c * grain;
+            std::size_t to = from + grain < end ? from + grain : end;
+            (*bodyPtr)(from, to);
+            if (++state->done == chunks) {
+                std::lock_guard<std::mutex> guard(state->lock);
+                state->finished.notify_all();
+            }
+        }
+    };
+
+    std::size_t helpers = chunks - 1 < workers.size() ? chunks - 1 : workers.size();
+    for (std::size_t i = 0; i < helpers; i++) enqueue(runChunks, priority);
+    runChunks();  // The caller works too instead of just blocking
+    std::unique_lock<std::mutex> guard(state->lock);
+    state->finished.wait(guard, [&]() { return state->done == chunks; });
+}
+
+/* ── GUI Thread Hand-off ─────────────────────────────────── */
+
+int Executor::runCompletions(double budgetMs) {
+    std::vector<Job> ready;
+    {
+        std::lock_guard<std::mutex> guard(completionLock);
+        ready.swap(completions);
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::size_t ran = 0;
+    while (ran < ready.size()) {
+        ready[ran++]();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() >= budgetMs) break;  // Keep the rest for the next frame
+    }
+    if (ran < ready.size()) {
+        std::lock_guard<std::mutex> guard(completionLock);
+        completions.insert(completions.begin(), ready.begin() + ran, ready.end());
+    }
+    return (int)ran;
+}
+
+int Executor::workerCount() const {
+    return (int)workers.size();
+}
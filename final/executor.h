@@ -0,0 +1,78 @@
+#pragma once
+/*
+ * executor.h ― Shared work-stealing thread pool for background work.
+ * The application owns one Executor. Each worker has its own deques (one per
+ * priority); it pops its newest job first and steals the oldest job of
+ * another worker when it runs dry. Low-priority jobs only run when no High
+ * or Normal job is queued anywhere. The pool leaves one core free for the
+ * render thread, and the render thread never runs jobs itself: results come
+ * back through futures or completion callbacks that the GUI drains with
+ * runCompletions() under a per-frame time budget.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Executor {
+public:
+    enum Priority { High = 0, Normal = 1, Low = 2 };
+    using Job = std::function<void()>;
+
+private:
+    struct Worker {
+        std::mutex lock;          // Guards the deques below
+        std::deque<Job> jobs[3];  // One deque per priority
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers; // Per-worker queues
+    std::vector<std::thread> threads;             // Worker threads
+    std::atomic<int> queued;                      // Jobs waiting in any deque
+    std::atomic<unsigned> nextWorker;             // Round-robin target for outside submissions
+    std::atomic<bool> stopping;                   // Set by the destructor
+    std::mutex sleepLock;                         // Paired with wake
+    std::condition_variable wake;                 // Signals idle workers that work arrived
+
+    std::mutex completionLock;                    // Guards completions
+    std::vector<Job> completions;                 // Callbacks waiting for the GUI thread
+
+    void enqueue(Job job, Priority priority);     // Pushes to the caller's deque or round-robin
+    bool takeJob(int self, Job& job);             // Own deque first, then steal, by priority
+    void workerLoop(int self);                    // Body of each worker thread
+
+public:
+    explicit Executor(int threadCount = 0);       // 0 = one fewer than the hardware threads (at least 1)
+    ~Executor();                                  // Finishes queued jobs, then joins the workers
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    // Runs fn on a worker and returns a future for its result
+    template <typename F>
+    auto submit(F fn, Priority priority = Normal) -> std::future<decltype(fn())> {
+        using Result = decltype(fn());
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::move(fn));
+        std::future<Result> result = task->get_future();
+        enqueue([task]() { (*task)(); }, priority);
+        return result;
+    }
+
+    // Runs job on a worker, then queues onComplete for the GUI thread's runCompletions()
+    void post(Job job, Job onComplete, Priority priority = Normal);
+
+    // Splits [begin, end) into chunks of at most grain items and runs body(chunkBegin, chunkEnd)
+    // on the pool; the calling thread helps and returns once every chunk is done. Call it from
+    // inside a job rather than from the render thread.
+    void parallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+                     const std::function<void(std::size_t, std::size_t)>& body, Priority priority = Normal);
+
+    int runCompletions(double budgetMs = 2.0);    // Runs queued callbacks on the caller's thread within a budget
+    int workerCount() const;                      // Number of worker threads
+};
@@ -11,6 +11,12 @@
 #include <ctime>
 #include <sstream>
 #include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <memory>
 
 /* Windows-specific for region & layered window */
 #include <Windows.h>
@@ -28,6 +34,9 @@
 
 /* 3. Project headers */
 #include "taskmanager.h"
+#include "sessionmerge.h"
+#include "executor.h"
+#include "summary.h"
 
 /* 4. GLFW error callback */
 static void glfw_error_callback(int error, const char* desc) {
@@ -59,7 +68,96 @@ static std::string formatDate(const struct tm& date) {
     return std::string(buf);
 }
 
-int main() {
+/* 8. Helper function to detect changes that invalidate the background summary */
+static size_t summaryFingerprint(TaskManager& manager, const struct tm& date) {
+    size_t h = std::hash<int>()(date.tm_year * 400 + date.tm_yday);  // Selected date
+    for (int i = 0; i < manager.getCount(); ++i) {
+        Task* t = manager.getTaskAt(i);
+        h = h * 31 + std::hash<std::string>()(t->getName());  // Renames
+        h = h * 31 + t->getSessions().size();                  // New, reset or deleted sessions
+    }
+    return h * 31 + manager.getCount();
+}
+
+/* 9. Helper function to find a task slot by exact name (task list is not sorted) */
+static int findTask(TaskManager& manager, const std::string& name) {
+    for (int i = 0; i < manager.getCount(); ++i) {
+        if (manager.getTaskAt(i)->getName() == name) return i;  // Exact name match
+    }
+    return -1;
+}
+
+/* 10. Headless mode: schedule actions from the command line and drain the timer wheel */
+//    FocusTime --headless [--pomodoro NAME WORK_MIN BREAK_MIN CYCLES]
+//                         [--autostop NAME MIN] [--budget NAME MIN]
+static int runHeadless(int argc, char** argv) {
+    TaskManager manager;
+    manager.loadFromFile("tasks.csv");  // Load existing tasks
+    manager.loadSessionsFromFile("sessions.csv");  // Load existing sessions
+    manager.tick(time(nullptr));  // Align the wheel with the wall clock
+
+    for (int i = 2; i < argc; ++i) {
+        std::string opt = argv[i];
+        int needed = opt == "--pomodoro" ? 4 : (opt == "--autostop" || opt == "--budget") ? 2 : -1;
+        if (needed < 0 || i + needed >= argc) {
+            std::cerr << "Unknown or incomplete option: " << opt << "\n";
+            return 1;
+        }
+        int index = findTask(manager, argv[i + 1]);
+        if (index == -1) {
+            manager.addTask(argv[i + 1]);  // Create the task on first use
+            index = findTask(manager, argv[i + 1]);
+            if (index == -1) return 1;  // Task limit reached
+        }
+        if (opt == "--pomodoro") {
+            manager.schedulePomodoro(index, std::atoll(argv[i + 2]) * 60, std::atoll(argv[i + 3]) * 60,
+                                     std::atoi(argv[i + 4]));
+        } else if (opt == "--autostop") {
+            manager.scheduleAutoStop(index, std::atoll(argv[i + 2]) * 60);
+        } else {
+            manager.scheduleBudgetAlert(index, std::atoll(argv[i + 2]) * 60);
+        }
+        i += needed;
+    }
+
+    // Runs until every action has fired; budget alerts re-arm daily and keep it alive until killed
+    while (manager.pendingTimers() > 0) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        if (manager.tick(time(nullptr)) > 0) {
+            manager.saveToFile("tasks.csv");  // Persist sessions logged by fired actions
+            manager.saveSessionsToFile("sessions.csv");
+        }
+    }
+    manager.saveToFile("tasks.csv");
+    manager.saveSessionsToFile("sessions.csv");
+    return 0;
+}
+
+/* 11. Merge mode: FocusTime --merge OUT_DIR DEVICE_DIR... (each dir holds tasks.csv + sessions.csv) */
+static int runMerge(int argc, char** argv) {
+    if (argc < 4) {
+        std::cerr << "Usage: FocusTime --merge OUT_DIR DEVICE_DIR...\n";
+        return 1;
+    }
+    std::vector<std::string> inputs(argv + 3, argv + argc);
+    SessionMerger merger;
+    SessionMerger::Report report;
+    bool ok = merger.mergeDirectories(inputs, argv[2], report);
+    std::cout << "Read " << report.rowsRead << " sessions, wrote " << report.rowsWritten
+              << " (duplicates " << report.duplicates << ", overlaps dropped " << report.overlapsDropped
+              << ", trimmed " << report.overlapsTrimmed << ", bad rows " << report.badRows
+              << ", corrupt blocks " << report.corruptBlocks << ")\n";
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--headless") {
+        return runHeadless(argc, argv);  // No window: timers only
+    }
+    if (argc > 1 && std::string(argv[1]) == "--merge") {
+        return runMerge(argc, argv);  // No window: combine device logs
+    }
+
     // 5.1 Init GLFW
     glfwSetErrorCallback(glfw_error_callback);  // Set up error callback
     if (!glfwInit()) return -1;  // Exit if GLFW initialization fails
@@ -104,7 +202,8 @@ int main() {
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init("#version 130");
 
-    // 5.7 Load tasks and sessions
+    // 5.7 Background executor (summary aggregation, loading, exports) and task data
+    Executor executor;
     TaskManager manager;
     manager.loadFromFile("tasks.csv");  // Load existing tasks
     manager.loadSessionsFromFile("sessions.csv");  // Load existing sessions
@@ -114,6 +213,10 @@ int main() {
     time_t now = time(nullptr);  // Get current time
     struct tm selected_date = *localtime(&now); // Default to today
     int selected_date_index = 0; // For combo box
+    SummaryResult summary;        // Latest background-computed summary
+    auto summary_snapshot = std::make_shared<std::vector<TaskSnapshot>>(); // Sessions the jobs read
+    bool summary_pending = false; // A summary job is in flight
+    size_t summary_fingerprint = 0; // Inputs the latest job was started for
     std::vector<struct tm> recent_dates(7); // Last 7 days
     std::vector<std::string> date_strings(7); // Persistent string storage
     std::vector<const char*> date_cstrings(7); // Persistent C-string pointers
@@ -127,8 +230,13 @@ int main() {
 
     // Main loop
     while (!glfwWindowShouldClose(window)) {
-        // 6.1 Poll events
+        // 6.1 Poll events and fire due scheduled actions
         glfwPollEvents();
+        executor.runCompletions();  // Results of background jobs, within a small frame budget
+        if (manager.tick(time(nullptr)) > 0) {
+            manager.saveToFile("tasks.csv");  // Auto-stop / Pomodoro changed sessions
+            manager.saveSessionsToFile("sessions.csv");
+        }
         // 6.2 New frame
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
@@ -197,6 +305,22 @@ int main() {
                         renaming = i;
                         ImGui::CloseCurrentPopup();
                     }
+                    if (ImGui::MenuItem("Pomodoro 25/5 x4")) {
+                        manager.schedulePomodoro(i, 25 * 60, 5 * 60, 4);  // Classic Pomodoro cycle
+                        ImGui::CloseCurrentPopup();
+                    }
+                    if (ImGui::MenuItem("Auto-stop in 60 min")) {
+                        manager.scheduleAutoStop(i, 60 * 60);  // Start now, stop in an hour
+                        ImGui::CloseCurrentPopup();
+                    }
+                    if (ImGui::MenuItem("Daily budget 2h")) {
+                        manager.scheduleBudgetAlert(i, 2 * 60 * 60);  // Warn after two hours today
+                        ImGui::CloseCurrentPopup();
+                    }
+                    if (ImGui::MenuItem("Cancel timers")) {
+                        manager.cancelTimers(i);  // Drop every scheduled action for the task
+                        ImGui::CloseCurrentPopup();
+                    }
                     if (ImGui::MenuItem("Delete")) {
                         manager.deleteTask(i);  // Delete task
                         ImGui::CloseCurrentPopup();
@@ -226,6 +350,10 @@ int main() {
             selected_date_index = 0; // Default to today
             selected_date = recent_dates[0];
         }
+        ImGui::SameLine();
+        if (ImGui::Button("Export Sessions")) {
+            manager.exportSessionReport("sessions_report.csv", ReportFormat::Csv);  // Spreadsheet-friendly copy of every session
+        }
 
         ImGui::End(); // End main window
 
@@ -254,17 +382,42 @@ int main() {
                 date_cstrings[0] = date_strings[0].c_str();   // Update C-string pointer
             }
 
-            // Calculate daily and cumulative totals
+            // Recompute the session-based totals in the background whenever their inputs change
+            size_t fingerprint = summaryFingerprint(manager, selected_date);
+            if (fingerprint != summary_fingerprint && !summary_pending) {
+                summary_pending = true;
+                summary_fingerprint = fingerprint;
+                refreshSnapshot(manager, *summary_snapshot);  // Safe: no job is reading it now
+                auto snapshot = summary_snapshot;
+                auto result = std::make_shared<SummaryResult>();
+                struct tm date = selected_date;
+                executor.post([snapshot, result, date, &executor]() {
+                                  *result = computeDailySummary(*snapshot, date, executor);  // Parallel over sessions
+                              },
+                              [result, &summary, &summary_pending]() {
+                                  summary = *result;  // Runs on this thread via runCompletions()
+                                  summary_pending = false;
+                              });
+            }
+
+            // Combine the background totals with the live time of running tasks. Until a job
+            // has finished for the selected date, the daily columns show a pending marker.
+            bool summary_ready = summary.date.tm_year == selected_date.tm_year &&
+                                 summary.date.tm_mon == selected_date.tm_mon &&
+                                 summary.date.tm_mday == selected_date.tm_mday;
             int64_t daily_total = 0;
             std::vector<std::tuple<std::string, int64_t, int64_t>> task_data; // name, daily, cumulative
             for (int i = 0; i < manager.getCount(); ++i) {
                 Task* t = manager.getTaskAt(i);
                 if (!t) continue;
                 int64_t task_daily = 0;
-                for (const auto& session : t->getSessions()) {
-                    if (isSessionOnDate(session, selected_date)) {
-                        task_daily += session.duration;  // Sum durations for the selected date
-                    }
+                if (summary_ready && i < (int)summary.names.size() && summary.names[i] == t->getName()) {
+                    task_daily = summary.daily[i];  // Finished sessions on the selected date
+                }
+                if (t->isRunning()) {
+                    Task::Session live = {(time_t)t->getLastStartTime(), time(nullptr), 0};
+                    live.duration = live.endTime - live.startTime;
+                    if (isSessionOnDate(live, selected_date)) task_daily += live.duration;  // Session in progress
                 }
                 daily_total += task_daily;
                 task_data.push_back({t->getName(), task_daily, t->getTotalDuration()});
@@ -284,10 +437,11 @@ int main() {
                     ImGui::TableSetColumnIndex(0);
                     ImGui::Text("%s", name.c_str());
                     ImGui::TableSetColumnIndex(1);
-                    ImGui::Text("%s", formatDuration(daily).c_str());
+                    ImGui::Text("%s", summary_ready ? formatDuration(daily).c_str() : "...");
                     ImGui::TableSetColumnIndex(2);
                     float percentage = daily_total > 0 ? (daily * 100.0f) / daily_total : 0.0f;
-                    ImGui::Text("%.1f%%", percentage);
+                    if (summary_ready) ImGui::Text("%.1f%%", percentage);
+                    else ImGui::Text("...");
                     ImGui::TableSetColumnIndex(3);
                     ImGui::Text("%s", formatDuration(cumulative).c_str());
                 }
@@ -295,7 +449,7 @@ int main() {
                 ImGui::TableSetColumnIndex(0);
                 ImGui::Text("Total");
                 ImGui::TableSetColumnIndex(1);
-                ImGui::Text("%s", formatDuration(daily_total).c_str());
+                ImGui::Text("%s", summary_ready ? formatDuration(daily_total).c_str() : "...");
                 ImGui::TableSetColumnIndex(2);
                 ImGui::Text("100.0%%");
                 ImGui::TableSetColumnIndex(3);
@@ -303,6 +457,35 @@ int main() {
                 ImGui::EndTable();
             }
 
+            // Session statistics (streaming, no rescan of the session history)
+            ImGui::Separator();
+            ImGui::Text("Session Statistics");
+            if (ImGui::BeginTable("StatsTable", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+                ImGui::TableSetupColumn("Task");
+                ImGui::TableSetupColumn("Median");
+                ImGui::TableSetupColumn("P90");
+                ImGui::TableSetupColumn("Best Streak");
+                ImGui::TableSetupColumn("Sessions/Day");
+                ImGui::TableHeadersRow();
+                SessionStats all = manager.groupStats();  // Group totals from merged sketches
+                for (int i = 0; i <= manager.getCount(); ++i) {
+                    Task* t = i < manager.getCount() ? manager.getTaskAt(i) : nullptr;
+                    const SessionStats& st = t ? t->getStats() : all;
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::Text("%s", t ? t->getName().c_str() : "All tasks");
+                    ImGui::TableSetColumnIndex(1);
+                    ImGui::Text("%s", formatDuration((int64_t)st.median()).c_str());
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::Text("%s", formatDuration((int64_t)st.p90()).c_str());
+                    ImGui::TableSetColumnIndex(3);
+                    ImGui::Text("%d days", st.longestStreak());
+                    ImGui::TableSetColumnIndex(4);
+                    ImGui::Text("%.1f", st.sessionsPerDay());
+                }
+                ImGui::EndTable();
+            }
+
             // Close button
             if (ImGui::Button("Close")) {
                 show_summary = false;  // Close summary window
@@ -0,0 +1,204 @@
+#include "sessionmerge.h"
+#include "sessionstore.h"
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <queue>
+
+namespace {
+
+// Parses a whole decimal field; false on empty, trailing junk or overflow
+bool parseNumber(const std::string& text, size_t from, size_t to, long long& value) {
+    if (from >= to) return false;
+    std::string field = text.substr(from, to - from);
+    char* endPtr = nullptr;
+    errno = 0;
+    value = std::strtoll(field.c_str(), &endPtr, 10);
+    return errno == 0 && endPtr == field.c_str() + field.size();
+}
+
+// One input file with its current (smallest unconsumed) row
+struct MergeInput {
+    explicit MergeInput(const std::string& path) : reader(path) {}
+    SessionReader reader;     // Verifies blocks and skips malformed rows
+    SessionRow row;
+    long long lastStart = 0;  // Start of the previous row, to detect unsorted files
+    bool hasRow = false;
+};
+
+// Reads the next valid row of an input
+void advanceInput(MergeInput& input, SessionMerger::Report& report) {
+    input.hasRow = input.reader.next(input.row);
+    if (!input.hasRow) return;
+    report.rowsRead++;
+    if (input.row.start < input.lastStart) report.outOfOrder++;
+    input.lastStart = input.row.start;
+}
+
+}  // namespace
+
+/* ── Task Matching ───────────────────────────────────────── */
+
+std::string SessionMerger::taskKey(const std::string& name) {
+    size_t first = 0, last = name.size();
+    while (first < last && std::isspace((unsigned char)name[first])) first++;      // Trim left
+    while (last > first && std::isspace((unsigned char)name[last - 1])) last--;    // Trim right
+    std::string key = name.substr(first, last - first);
+    for (char& c : key) c = (char)std::tolower((unsigned char)c);  // Same task regardless of case
+    return key;
+}
+
+/* ── Session Merge ───────────────────────────────────────── */
+
+bool SessionMerger::mergeSessions(const std::vector<std::string>& inputs, const std::string& outFile,
+                                  Report& report) {
+    totals.clear();
+    byKey.clear();
+
+    std::vector<std::unique_ptr<MergeInput>> streams;
+    for (const std::string& path : inputs) {
+        std::unique_ptr<MergeInput> input(new MergeInput(path));
+        if (!input->reader.isOpen()) {
+            std::cerr << "Cannot open " << path << ", skipping.\n";
+            continue;
+        }
+        streams.push_back(std::move(input));
+    }
+
+    SessionWriter out(outFile);  // Checksummed blocks, renamed into place on success
+
+    // Min-heap of input indices keyed by their current row: one pending row per input
+    auto later = [&streams](int a, int b) {
+        const SessionRow& ra = streams[a]->row;
+        const SessionRow& rb = streams[b]->row;
+        if (ra.start != rb.start) return ra.start > rb.start;
+        if (ra.end != rb.end) return ra.end > rb.end;
+        return a > b;
+    };
+    std::priority_queue<int, std::vector<int>, decltype(later)> heap(later);
+    for (int i = 0; i < (int)streams.size(); i++) {
+        advanceInput(*streams[i], report);
+        if (streams[i]->hasRow) heap.push(i);
+    }
+
+    while (!heap.empty()) {
+        int i = heap.top();
+        heap.pop();
+        SessionRow row = streams[i]->row;
+        advanceInput(*streams[i], report);  // Refill before processing so the heap stays primed
+        if (streams[i]->hasRow) heap.push(i);
+
+        std::string key = taskKey(row.name);
+        auto found = byKey.find(key);
+        int index;
+        if (found == byKey.end()) {
+            index = (int)totals.size();
+            byKey[key] = index;
+            totals.push_back(TaskTotal());
+            totals[index].name = row.name;  // Keep the first spelling seen
+        } else {
+            index = found->second;
+        }
+        TaskTotal& task = totals[index];
+
+        if (task.lastEnd != 0) {
+            if (row.start == task.lastStart && row.end == task.lastEnd) {
+                report.duplicates++;  // Same session logged by two devices
+                continue;
+            }
+            if (row.end <= task.lastEnd) {
+                report.overlapsDropped++;  // Entirely inside time already counted
+                continue;
+            }
+            if (row.start < task.lastEnd) {
+                row.start = task.lastEnd;  // Count only the part after the previous session
+                row.duration = row.end - row.start;
+                report.overlapsTrimmed++;
+            }
+        }
+        out.write(task.name, row.start, row.end, row.duration);
+        task.lastStart = row.start;
+        task.lastEnd = row.end;
+        task.seconds += row.duration;
+        report.rowsWritten++;
+    }
+    for (const auto& input : streams) {
+        report.badRows += input->reader.getBadRows();
+        report.corruptBlocks += input->reader.getCorruptBlocks();
+        for (const std::string& problem : input->reader.getProblems()) std::cerr << problem << "\n";
+    }
+    if (report.outOfOrder > 0) {
+        std::cerr << report.outOfOrder << " rows were not sorted by start time; "
+                  << "overlap removal may be incomplete. Re-save inputs with the current version first.\n";
+    }
+    return out.commit();
+}
+
+/* ── Task Merge ──────────────────────────────────────────── */
+
+bool SessionMerger::mergeTasks(const std::vector<std::string>& inputs, const std::string& outFile) {
+    std::vector<std::string> names;              // Output order: tasks files first, then session-only tasks
+    std::vector<std::string> nameKeys;
+    std::unordered_map<std::string, long long> deviceMax; // Largest total any device reported
+    for (const std::string& path : inputs) {
+        std::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            size_t comma = line.rfind(',');
+            long long duration;
+            if (comma == std::string::npos || !parseNumber(line, comma + 1, line.size(), duration)) continue;
+            std::string name = line.substr(0, comma);
+            std::string key = taskKey(name);
+            auto found = deviceMax.find(key);
+            if (found == deviceMax.end()) {
+                deviceMax[key] = duration;
+                names.push_back(name);
+                nameKeys.push_back(key);
+            } else if (duration > found->second) {
+                found->second = duration;
+            }
+        }
+    }
+    for (const TaskTotal& task : totals) {
+        std::string key = taskKey(task.name);
+        if (deviceMax.find(key) == deviceMax.end()) {
+            deviceMax[key] = 0;  // Task only known from its sessions
+            names.push_back(task.name);
+            nameKeys.push_back(key);
+        }
+    }
+
+    std::ofstream out(outFile);
+    if (!out.is_open()) return false;
+    for (size_t i = 0; i < names.size(); i++) {
+        long long total = deviceMax[nameKeys[i]];  // Only used for tasks without sessions
+        auto merged = byKey.find(nameKeys[i]);
+        if (merged != byKey.end()) {
+            total = totals[merged->second].seconds;  // Deduplicated sessions from every device
+        }
+        out << names[i] << "," << total << "\n";
+    }
+    out.close();
+    return !out.fail();
+}
+
+/* ── Directory Merge ─────────────────────────────────────── */
+
+bool SessionMerger::mergeDirectories(const std::vector<std::string>& inputDirs, const std::string& outDir,
+                                     Report& report) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(outDir, ec);
+    std::vector<std::string> sessionFiles, taskFiles;
+    for (const std::string& dir : inputDirs) {
+        sessionFiles.push_back((fs::path(dir) / "sessions.csv").string());
+        taskFiles.push_back((fs::path(dir) / "tasks.csv").string());
+    }
+    return mergeSessions(sessionFiles, (fs::path(outDir) / "sessions.csv").string(), report) &&
+           mergeTasks(taskFiles, (fs::path(outDir) / "tasks.csv").string());
+}
@@ -0,0 +1,52 @@
+#pragma once
+/*
+ * sessionmerge.h ― Combines task and session logs written by several devices.
+ * Each device keeps its own tasks.csv/sessions.csv. SessionMerger streams N
+ * time-sorted session files through a k-way heap merge, so only one pending
+ * row per input is held in memory no matter how large the files are. Tasks
+ * are matched by name (surrounding whitespace and letter case ignored), exact
+ * duplicates are dropped, and overlapping sessions of the same task are
+ * trimmed so no second is counted twice. Task totals are rebuilt from the
+ * merged sessions, falling back to the largest device total for tasks whose
+ * time was never logged as sessions.
+ */
+
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class SessionMerger {
+public:
+    struct Report {
+        long long rowsRead = 0;        // Session rows read across all inputs
+        long long rowsWritten = 0;     // Session rows in the merged output
+        long long duplicates = 0;      // Rows identical to one already written
+        long long overlapsDropped = 0; // Rows fully covered by an earlier session of the task
+        long long overlapsTrimmed = 0; // Rows whose start was moved past an earlier session
+        long long badRows = 0;         // Rows that could not be parsed
+        long long corruptBlocks = 0;   // Input blocks that failed checksum verification
+        long long outOfOrder = 0;      // Rows older than the previous row of the same input
+    };
+
+    static std::string taskKey(const std::string& name); // Normalized name used to match tasks
+
+    // Merges session files into outFile; inputs must be sorted by start time
+    bool mergeSessions(const std::vector<std::string>& inputs, const std::string& outFile, Report& report);
+
+    // Merges tasks files into outFile, using totals from the last mergeSessions() call
+    bool mergeTasks(const std::vector<std::string>& inputs, const std::string& outFile);
+
+    // Merges DIR/tasks.csv and DIR/sessions.csv of every input directory into outDir
+    bool mergeDirectories(const std::vector<std::string>& inputDirs, const std::string& outDir, Report& report);
+
+private:
+    struct TaskTotal {
+        std::string name;      // Spelling of the first occurrence
+        long long seconds = 0; // Sum of merged session durations
+        time_t lastEnd = 0;    // End of the latest session written for the task
+        time_t lastStart = 0;  // Start of the latest session written for the task
+    };
+    std::vector<TaskTotal> totals;                // One entry per distinct task, in first-seen order
+    std::unordered_map<std::string, int> byKey;   // Task key -> index into totals
+};
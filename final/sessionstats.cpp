@@ -0,0 +1,229 @@
+#include "sessionstats.h"
+#include <algorithm>
+#include <cmath>
+
+/* ── Construction ────────────────────────────────────────── */
+
+SessionStats::SessionStats() {
+    clear();  // Start from an empty digest and day window
+}
+
+void SessionStats::clear() {
+    centroidCount = 0;
+    bufferCount = 0;
+    minLength = 0;
+    maxLength = 0;
+    sessionCount = 0;
+    totalSeconds = 0;
+    days.reset();
+    lastDay = -1;     // No active day yet
+    activeDays = 0;
+    streak = 0;
+    bestStreak = 0;
+    cachedDayStart = 0;
+    cachedDayEnd = 0;  // Empty span: first lookup always misses
+    cachedDay = -1;
+}
+
+/* ── t-digest ────────────────────────────────────────────── */
+
+// k1 scale function: centroids near the tails stay small, so p90 stays accurate
+static double scaleK(double q) {
+    return SessionStats::Compression / (2.0 * 3.14159265358979323846) * std::asin(2.0 * q - 1.0);
+}
+
+void SessionStats::push(double mean, double weight) {
+    if (bufferCount == BufferSize) compress();  // Keep the footprint fixed
+    buffer[bufferCount++] = {mean, weight};
+}
+
+void SessionStats::compress() const {
+    if (bufferCount == 0) return;
+    Centroid all[MaxCentroids + BufferSize];
+    int n = 0;
+    double total = 0;
+    for (int i = 0; i < centroidCount; i++) { all[n++] = centroids[i]; total += centroids[i].weight; }
+    for (int i = 0; i < bufferCount; i++) { all[n++] = buffer[i]; total += buffer[i].weight; }
+    std::sort(all, all + n, [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+    if (n == 0) return;  // Never (bufferCount > 0), but lets the compiler see all[0] is set
+
+    int out = 0;
+    Centroid current = all[0];
+    double before = 0;  // Weight of all centroids emitted so far
+    for (int i = 1; i < n; i++) {
+        double proposed = current.weight + all[i].weight;
+        bool fits = scaleK((before + proposed) / total) - scaleK(before / total) <= 1.0;
+        if (fits || out == MaxCentroids - 1) {
+            current.mean += (all[i].mean - current.mean) * all[i].weight / proposed;  // Weighted mean
+            current.weight = proposed;
+        } else {
+            centroids[out++] = current;  // Centroid is full: emit it
+            before += current.weight;
+            current = all[i];
+        }
+    }
+    centroids[out++] = current;
+    centroidCount = out;
+    bufferCount = 0;
+}
+
+/* ── Day Tracking ────────────────────────────────────────── */
+
+// Days from a civil date (proleptic Gregorian), 1970-01-01 = 0
+static long long daysFromCivil(const struct tm& local) {
+    long long y = local.tm_year + 1900;
+    long long m = local.tm_mon + 1;
+    long long d = local.tm_mday;
+    y -= m <= 2;
+    long long era = (y >= 0 ? y : y - 399) / 400;
+    long long yoe = y - era * 400;
+    long long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+long long SessionStats::dayNumber(time_t t) {
+    return daysFromCivil(*localtime(&t));
+}
+
+long long SessionStats::dayOf(time_t t) {
+    if (t >= cachedDayStart && t < cachedDayEnd) return cachedDay;  // Same day as the previous session
+    struct tm local = *localtime(&t);
+    cachedDay = daysFromCivil(local);
+    cachedDayStart = t - (local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec);
+    cachedDayEnd = cachedDayStart + 23 * 3600;  // Shortest possible day, so DST shifts never mislabel
+    return cachedDay;
+}
+
+int SessionStats::runThrough(int bit) const {
+    int run = 1;
+    for (int k = bit - 1; k >= 0 && days[k]; k--) run++;         // Later days
+    for (int k = bit + 1; k < DayWindow && days[k]; k++) run++;  // Earlier days
+    return run;
+}
+
+void SessionStats::markDay(long long day) {
+    if (lastDay < 0 || day > lastDay) {
+        long long gap = lastDay < 0 ? DayWindow : day - lastDay;
+        if (gap >= DayWindow) days.reset();   // Whole window scrolled out
+        else days <<= (size_t)gap;            // Bit 0 becomes the new day
+        days.set(0);
+        activeDays++;
+        streak = (gap == 1) ? streak + 1 : 1; // Chronological append: O(1) streak update
+        lastDay = day;
+        bestStreak = std::max(bestStreak, streak);
+        return;
+    }
+    long long age = lastDay - day;
+    if (age >= DayWindow || days[(size_t)age]) return;  // Too old to track, or already active
+    days.set((size_t)age);                              // Backfilled day inside the window
+    activeDays++;
+    int run = runThrough((int)age);
+    bestStreak = std::max(bestStreak, run);
+    streak = runThrough(0);  // A backfill can join onto the current streak
+}
+
+/* ── Updates ─────────────────────────────────────────────── */
+
+void SessionStats::add(time_t start, long long duration) {
+    double length = (double)duration;
+    if (sessionCount == 0 || length < minLength) minLength = length;
+    if (sessionCount == 0 || length > maxLength) maxLength = length;
+    sessionCount++;
+    totalSeconds += duration;
+    push(length, 1.0);       // One session = one unit-weight point
+    markDay(dayOf(start));
+}
+
+void SessionStats::merge(const SessionStats& other) {
+    if (other.sessionCount == 0) return;
+    other.compress();
+    for (int i = 0; i < other.centroidCount; i++) {
+        push(other.centroids[i].mean, other.centroids[i].weight);  // Centroids merge like weighted points
+    }
+    if (sessionCount == 0 || other.minLength < minLength) minLength = other.minLength;
+    if (sessionCount == 0 || other.maxLength > maxLength) maxLength = other.maxLength;
+    sessionCount += other.sessionCount;
+    totalSeconds += other.totalSeconds;
+
+    // Align both day windows on the later last day and union them
+    long long newLast = std::max(lastDay, other.lastDay);
+    std::bitset<DayWindow> mine = days, theirs = other.days;
+    long long shiftMine = newLast - lastDay, shiftTheirs = newLast - other.lastDay;
+    if (lastDay < 0 || shiftMine >= DayWindow) mine.reset(); else mine <<= (size_t)shiftMine;
+    if (shiftTheirs >= DayWindow) theirs.reset(); else theirs <<= (size_t)shiftTheirs;
+    long long outsideMine = activeDays - (long long)mine.count();        // Days only known as a count
+    long long outsideTheirs = other.activeDays - (long long)theirs.count();
+    days = mine | theirs;
+    lastDay = newLast;
+    activeDays = (long long)days.count() + std::max(outsideMine, outsideTheirs);
+
+    int best = std::max(bestStreak, other.bestStreak);
+    for (int k = 0; k < DayWindow; k++) {
+        if (days[k] && (k == 0 || !days[k - 1])) best = std::max(best, runThrough(k));  // Runs formed by the union
+    }
+    bestStreak = best;
+    streak = days[0] ? runThrough(0) : 0;
+}
+
+/* ── Queries ─────────────────────────────────────────────── */
+
+long long SessionStats::count() const {
+    return sessionCount;  // Number of sessions recorded
+}
+
+double SessionStats::quantile(double q) const {
+    if (sessionCount == 0) return 0;
+    compress();  // Fold pending values so the centroid list is complete
+    if (q <= 0) return minLength;
+    if (q >= 1) return maxLength;
+    if (centroidCount == 1) return centroids[0].mean;
+
+    double total = 0;
+    for (int i = 0; i < centroidCount; i++) total += centroids[i].weight;
+    double index = q * total;
+
+    // Below the first centroid's center: interpolate from the minimum
+    if (index < centroids[0].weight / 2) {
+        return minLength + (centroids[0].mean - minLength) * index / (centroids[0].weight / 2);
+    }
+    double cumulative = 0;
+    for (int i = 0; i + 1 < centroidCount; i++) {
+        double left = cumulative + centroids[i].weight / 2;
+        double right = cumulative + centroids[i].weight + centroids[i + 1].weight / 2;
+        if (index < right) {
+            double t = (index - left) / (right - left);  // Linear between neighbouring centers
+            return centroids[i].mean + t * (centroids[i + 1].mean - centroids[i].mean);
+        }
+        cumulative += centroids[i].weight;
+    }
+    // Above the last centroid's center: interpolate to the maximum
+    const Centroid& last = centroids[centroidCount - 1];
+    double left = total - last.weight / 2;
+    double t = (index - left) / (total - left);
+    return last.mean + t * (maxLength - last.mean);
+}
+
+double SessionStats::median() const {
+    return quantile(0.5);
+}
+
+double SessionStats::p90() const {
+    return quantile(0.9);
+}
+
+double SessionStats::mean() const {
+    return sessionCount > 0 ? (double)totalSeconds / sessionCount : 0.0;  // Exact running mean
+}
+
+int SessionStats::longestStreak() const {
+    return bestStreak;
+}
+
+int SessionStats::currentStreak() const {
+    return streak;
+}
+
+double SessionStats::sessionsPerDay() const {
+    return activeDays > 0 ? (double)sessionCount / activeDays : 0.0;
+}
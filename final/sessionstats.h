@@ -0,0 +1,74 @@
+#pragma once
+/*
+ * sessionstats.h ― Streaming per-task session analytics with a fixed memory footprint.
+ * SessionStats is updated once per logged session and never needs the session
+ * history again. Session lengths go into a merging t-digest (bounded number of
+ * centroids) for median/p90 queries, and the active days are tracked in a
+ * 512-day bitmap ending at the latest day seen, which gives consecutive-day
+ * streaks and sessions-per-day. Two SessionStats merge into one, so group
+ * totals are a fold over the tasks. Streaks and day counts are exact for
+ * sessions logged in time order; backfilled days older than the bitmap window
+ * are counted as sessions but not as active days.
+ */
+
+#include <ctime>
+#include <bitset>
+#include <cstdint>
+
+class SessionStats {
+public:
+    static const int Compression = 100;   // t-digest compression (higher = more accurate, more centroids)
+    static const int MaxCentroids = 2 * Compression; // Upper bound on centroids after a compress
+    static const int BufferSize = 256;    // Incoming values buffered before each compress
+    static const int DayWindow = 512;     // Days of history kept for streak tracking
+
+private:
+    struct Centroid {
+        double mean;    // Mean session length of the centroid in seconds
+        double weight;  // Number of sessions merged into the centroid
+    };
+
+    // Digest state is mutable so const queries can fold pending values first
+    mutable Centroid centroids[MaxCentroids]; // Compressed digest, sorted by mean
+    mutable int centroidCount;                // Centroids currently in use
+    mutable Centroid buffer[BufferSize];      // Values (or merged-in centroids) awaiting compression
+    mutable int bufferCount;                  // Entries currently in the buffer
+    double minLength;                 // Shortest session seen in seconds
+    double maxLength;                 // Longest session seen in seconds
+
+    long long sessionCount;           // Number of sessions recorded
+    long long totalSeconds;           // Sum of all session lengths
+    std::bitset<DayWindow> days;      // Bit k set if there was a session on lastDay - k
+    long long lastDay;                // Latest active day number (days since 1970-01-01, local time)
+    long long activeDays;             // Distinct days with at least one session
+    int streak;                       // Consecutive active days ending at lastDay
+    int bestStreak;                   // Longest run of consecutive active days
+    time_t cachedDayStart;            // Start of the span known to fall on cachedDay
+    time_t cachedDayEnd;              // End (exclusive) of that span
+    long long cachedDay;              // Day number of the last localtime() lookup
+
+    void push(double mean, double weight); // Buffers a weighted value, compressing when full
+    void compress() const;                 // Folds the buffer into the centroid list
+    void markDay(long long day);           // Records activity on a day
+    int runThrough(int bit) const;         // Length of the run of set bits containing a bit
+    long long dayOf(time_t t);             // dayNumber() with a one-day cache to skip localtime()
+
+public:
+    SessionStats();                        // Creates empty statistics
+
+    void add(time_t start, long long duration); // Records one session (O(1) amortized)
+    void merge(const SessionStats& other);      // Folds another task's statistics into this one
+    void clear();                               // Forgets everything recorded so far
+
+    /* ── Queries ────────────────────────────────────────────── */
+    long long count() const;            // Number of sessions recorded
+    double quantile(double q) const;    // Approximate session length at quantile q in [0, 1]
+    double median() const;              // Approximate median session length in seconds
+    double p90() const;                 // Approximate 90th-percentile session length in seconds
+    double mean() const;                // Exact mean session length in seconds
+    int longestStreak() const;          // Longest run of consecutive active days
+    int currentStreak() const;          // Run of consecutive active days ending at the latest one
+    double sessionsPerDay() const;      // Average sessions per active day
+
+    static long long dayNumber(time_t t); // Local calendar day of a timestamp as days since 1970-01-01
+};
@@ -0,0 +1,218 @@
+#include "sessionstore.h"
+#include "crc32c.h"
+#include "../common/csvschema.h"
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static const char* const FileMagic = "FTSESSIONS 1";  // First line of block-format files
+static const size_t MaxProblems = 100;                // Detailed messages kept per file
+
+/* ── Row Parsing ─────────────────────────────────────────── */
+
+// A session row as it appears in the file; the name points into the line
+struct SessionLine {
+    std::string_view name;
+    long long start;
+    long long end;
+    long long duration;
+};
+
+// Task names may contain commas, so the numbers are split off from the right
+static const CsvSchema sessionSchema(CsvField<&SessionLine::name, CsvCommaText>("name"),
+                                     CsvField<&SessionLine::start>("start"),
+                                     CsvField<&SessionLine::end>("end"),
+                                     CsvField<&SessionLine::duration>("duration"));
+
+bool parseSessionRow(const char* line, size_t length, SessionRow& row) {
+    SessionLine fields;
+    if (sessionSchema.parse(line, line + length, fields) >= 0) return false;
+    if (fields.end < fields.start || fields.duration < 0) return false;
+    row.name.assign(fields.name.data(), fields.name.size());
+    row.start = fields.start;
+    row.end = fields.end;
+    row.duration = fields.duration;
+    return true;
+}
+
+/* ── SessionReader ───────────────────────────────────────── */
+
+SessionReader::SessionReader(const std::string& filename) : in(filename, std::ios::binary) {
+    blocked = false;
+    pos = 0;
+    badRows = 0;
+    corruptBlocks = 0;
+    blockIndex = 0;
+    std::string first;
+    if (in.is_open() && std::getline(in, first)) {
+        if (!first.empty() && first.back() == '\r') first.pop_back();
+        if (first == FileMagic) {
+            blocked = true;  // Checksummed format: rows come from verified blocks
+        } else {
+            block = first + "\n";  // Legacy CSV: the first line is already a row
+        }
+    }
+}
+
+bool SessionReader::isOpen() const {
+    return in.is_open();
+}
+
+bool SessionReader::loadBlock() {
+    std::string header;
+    bool resyncing = false;
+    while (std::getline(in, header)) {
+        if (header.compare(0, 3, "#B ") != 0) {
+            if (!resyncing) {
+                if (problems.size() < MaxProblems) {
+                    problems.push_back("Unexpected data after block " + std::to_string(blockIndex) +
+                                       ", skipping to the next block header");
+                }
+                resyncing = true;
+            }
+            continue;  // Scan forward for the next block header
+        }
+        resyncing = false;
+        blockIndex++;
+        int rows = 0;
+        unsigned long long bytes = 0;
+        unsigned int expected = 0;
+        if (std::sscanf(header.c_str(), "#B %d %llu %x", &rows, &bytes, &expected) != 3 ||
+            bytes > 64ull * 1024 * 1024) {
+            corruptBlocks++;
+            if (problems.size() < MaxProblems) {
+                problems.push_back("Block " + std::to_string(blockIndex) + ": unreadable header");
+            }
+            continue;
+        }
+        std::streampos payload = in.tellg();  // A damaged byte count may run into later blocks
+        block.resize((size_t)bytes);
+        in.read(&block[0], (std::streamsize)bytes);
+        bool truncated = (unsigned long long)in.gcount() != bytes;
+        if (truncated || crc32c(block.data(), block.size()) != expected) {
+            corruptBlocks++;
+            if (problems.size() < MaxProblems) {
+                problems.push_back("Block " + std::to_string(blockIndex) +
+                                   (truncated ? std::string(": truncated") :
+                                                ": checksum mismatch, " + std::to_string(rows) + " rows skipped"));
+            }
+            block.clear();
+            in.clear();
+            in.seekg(payload);  // Look for the next header from just after this one
+            resyncing = true;   // Already reported; the payload lines are skipped quietly
+            continue;
+        }
+        pos = 0;
+        return true;
+    }
+    return false;
+}
+
+bool SessionReader::next(SessionRow& row) {
+    while (true) {
+        if (pos < block.size()) {
+            const char* start = block.data() + pos;
+            const char* newline = static_cast<const char*>(std::memchr(start, '\n', block.size() - pos));
+            size_t length = newline ? (size_t)(newline - start) : block.size() - pos;
+            pos += length + 1;
+            if (length == 0 || (length == 1 && start[0] == '\r')) continue;  // Blank line
+            if (parseSessionRow(start, length, row)) return true;
+            badRows++;
+            if (problems.size() < MaxProblems) {
+                problems.push_back("Malformed row skipped: " + std::string(start, length));
+            }
+            continue;
+        }
+        block.clear();
+        pos = 0;
+        if (blocked) {
+            if (!loadBlock()) return false;  // No more verified blocks
+        } else {
+            std::string line;
+            if (!std::getline(in, line)) return false;
+            block = line + "\n";  // Legacy files are parsed one line at a time
+        }
+    }
+}
+
+long long SessionReader::getBadRows() const {
+    return badRows;
+}
+
+int SessionReader::getCorruptBlocks() const {
+    return corruptBlocks;
+}
+
+const std::vector<std::string>& SessionReader::getProblems() const {
+    return problems;
+}
+
+/* ── SessionWriter ───────────────────────────────────────── */
+
+SessionWriter::SessionWriter(const std::string& filename) {
+    target = filename;
+    tempName = filename + ".tmp";
+    blockRows = 0;
+    out = std::fopen(tempName.c_str(), "wb");
+    failed = out == nullptr;
+    if (out) {
+        std::fputs(FileMagic, out);
+        std::fputc('\n', out);
+    }
+}
+
+SessionWriter::~SessionWriter() {
+    if (out) {
+        std::fclose(out);
+        std::remove(tempName.c_str());  // Abandoned write: keep the previous file
+    }
+}
+
+void SessionWriter::write(const std::string& name, long long start, long long end, long long duration) {
+    SessionLine line = {name, start, end, duration};
+    size_t used = block.size();
+    block.resize(used + name.size() + 64);  // Three numbers, commas and the newline fit in 64 bytes
+    char* stop = sessionSchema.write(&block[used], &block[0] + block.size(), line);
+    block.resize((size_t)(stop - block.data()));
+    blockRows++;
+    if (block.size() >= BlockBytes) flushBlock();  // Keep blocks small so damage stays local
+}
+
+void SessionWriter::flushBlock() {
+    if (blockRows == 0) return;
+    char header[64];
+    int n = std::snprintf(header, sizeof(header), "#B %d %zu %08x\n", blockRows, block.size(),
+                          crc32c(block.data(), block.size()));
+    if (out && (std::fwrite(header, 1, (size_t)n, out) != (size_t)n ||
+                std::fwrite(block.data(), 1, block.size(), out) != block.size())) {
+        failed = true;
+    }
+    block.clear();
+    blockRows = 0;
+}
+
+bool SessionWriter::commit() {
+    if (!out) return false;
+    flushBlock();
+    if (std::fflush(out) != 0) failed = true;
+#ifdef _WIN32
+    if (_commit(_fileno(out)) != 0) failed = true;  // Data on disk before the rename
+#else
+    if (fsync(fileno(out)) != 0) failed = true;
+#endif
+    if (std::fclose(out) != 0) failed = true;
+    out = nullptr;
+    if (failed) {
+        std::remove(tempName.c_str());
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tempName, target, ec);  // Atomic replace of the old file
+    if (ec) std::remove(tempName.c_str());
+    return !ec;
+}
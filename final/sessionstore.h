@@ -0,0 +1,72 @@
+#pragma once
+/*
+ * sessionstore.h ― Checksummed, crash-safe storage for session logs.
+ * sessions.csv keeps its human-readable rows (name,start,end,duration) but
+ * is written in blocks of up to 64 KiB, each preceded by a header line
+ * "#B <rows> <bytes> <crc32c>". SessionWriter writes to a temporary file and
+ * renames it over the target only after everything is flushed, so a crash
+ * leaves the previous file intact. SessionReader verifies every block before
+ * parsing it; corrupt or truncated blocks and unparsable rows are reported
+ * and skipped instead of aborting the load. After a bad block, reading
+ * resumes at the first header past its own, so a damaged byte count costs
+ * only that block. Files written before the block format (plain CSV rows)
+ * are still read, row by row.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct SessionRow {
+    std::string name;    // Task name
+    long long start;     // Session start in epoch seconds
+    long long end;       // Session end in epoch seconds
+    long long duration;  // Logged duration in seconds
+};
+
+bool parseSessionRow(const char* line, size_t length, SessionRow& row); // Parses one CSV row; false if malformed
+
+class SessionReader {
+private:
+    std::ifstream in;            // Underlying file
+    bool blocked;                // True for the checksummed block format
+    std::string block;           // Payload of the current verified block (or the pending legacy line)
+    size_t pos;                  // Read position inside block
+    long long badRows;           // Rows that failed to parse
+    int corruptBlocks;           // Blocks skipped because of checksum or framing errors
+    long long blockIndex;        // Number of block headers seen so far
+    std::vector<std::string> problems; // Human-readable descriptions of everything skipped
+
+    bool loadBlock();            // Reads and verifies the next block into block; false at end of file
+
+public:
+    explicit SessionReader(const std::string& filename); // Opens a session file in either format
+
+    bool isOpen() const;                 // Returns true if the file could be opened
+    bool next(SessionRow& row);          // Reads the next valid row; false when the file is exhausted
+    long long getBadRows() const;        // Number of malformed rows skipped
+    int getCorruptBlocks() const;        // Number of blocks that failed verification
+    const std::vector<std::string>& getProblems() const; // Details of skipped rows and blocks
+};
+
+class SessionWriter {
+private:
+    std::string target;          // Final file name
+    std::string tempName;        // File written until commit()
+    FILE* out;                   // Handle of the temporary file
+    std::string block;           // Rows of the block being built
+    int blockRows;               // Rows in the current block
+    bool failed;                 // Set on any write error
+
+    void flushBlock();           // Writes the current block with its header
+
+public:
+    static const size_t BlockBytes = 64 * 1024; // Payload size that triggers a new block
+
+    explicit SessionWriter(const std::string& filename); // Starts writing filename's temporary file
+    ~SessionWriter();            // Discards the temporary file if commit() was never called
+
+    void write(const std::string& name, long long start, long long end, long long duration); // Appends a row
+    bool commit();               // Flushes, syncs and atomically replaces the target file
+};
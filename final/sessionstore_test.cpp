@@ -0,0 +1,124 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "sessionstore.h"
+
+// Build: g++ -std=c++17 -O2 sessionstore_test.cpp sessionstore.cpp crc32c.cpp
+//
+// Writes a session file of several blocks, damages one block at a time (a byte count that runs
+// past the end of the file, one that runs into the next block, one that stops short, a flipped
+// payload byte) and checks that SessionReader skips only the damaged block and still returns
+// every row of the others. Exits 1 on any failure.
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        std::printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+static const char* const Path = "sessionstore_test.csv";
+
+// A block header found in the file
+struct BlockInfo {
+    size_t headerStart;   // Offset of "#B"
+    size_t countStart;    // Offset of the byte count
+    size_t countLength;   // Digits in the byte count
+    size_t payloadStart;  // Offset just after the header line
+    long long rows;
+};
+
+static std::string readFile() {
+    std::ifstream in(Path, std::ios::binary);
+    std::stringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+static void writeFile(const std::string& text) {
+    std::ofstream(Path, std::ios::binary | std::ios::trunc) << text;
+}
+
+static std::vector<BlockInfo> findBlocks(const std::string& text) {
+    std::vector<BlockInfo> blocks;
+    size_t at = text.find('\n') + 1;  // Past the magic line
+    while (at < text.size() && text.compare(at, 3, "#B ") == 0) {
+        BlockInfo b;
+        b.headerStart = at;
+        size_t rowsEnd = text.find(' ', at + 3);
+        b.rows = std::stoll(text.substr(at + 3, rowsEnd - at - 3));
+        b.countStart = rowsEnd + 1;
+        b.countLength = text.find(' ', b.countStart) - b.countStart;
+        b.payloadStart = text.find('\n', at) + 1;
+        blocks.push_back(b);
+        at = b.payloadStart + std::stoull(text.substr(b.countStart, b.countLength));
+    }
+    return blocks;
+}
+
+// Reads the file and returns the rows; every row's start must be its number in the file
+static long long readRows(int& corrupt, bool& inOrder) {
+    SessionReader reader(Path);
+    SessionRow row;
+    long long rows = 0, last = -1;
+    inOrder = true;
+    while (reader.next(row)) {
+        inOrder = inOrder && row.start > last && row.name == "Task " + std::to_string(row.start % 7);
+        last = row.start;
+        rows++;
+    }
+    corrupt = reader.getCorruptBlocks();
+    return rows;
+}
+
+// Replaces block b's byte count with count and checks that only block b is lost
+static void damagedCount(const std::string& original, const std::vector<BlockInfo>& blocks, size_t b,
+                         const std::string& count, long long totalRows, const char* what) {
+    std::string text = original;
+    text.replace(blocks[b].countStart, blocks[b].countLength, count);
+    writeFile(text);
+    int corrupt = 0;
+    bool inOrder = false;
+    long long rows = readRows(corrupt, inOrder);
+    check(rows == totalRows - blocks[b].rows && corrupt == 1 && inOrder, what);
+}
+
+int main() {
+    const long long TotalRows = 9000;
+    {
+        SessionWriter writer(Path);
+        for (long long i = 0; i < TotalRows; i++) {
+            writer.write("Task " + std::to_string(i % 7), i, i + 1500, 1500);
+        }
+        check(writer.commit(), "commit");
+    }
+    std::string original = readFile();
+    std::vector<BlockInfo> blocks = findBlocks(original);
+    check(blocks.size() >= 3, "the file has at least three blocks");
+    if (blocks.size() < 3) return 1;
+
+    int corrupt = 0;
+    bool inOrder = false;
+    check(readRows(corrupt, inOrder) == TotalRows && corrupt == 0 && inOrder, "intact file reads every row");
+
+    std::string count = original.substr(blocks[1].countStart, blocks[1].countLength);
+    long long bytes = std::stoll(count);
+    damagedCount(original, blocks, 1, count + "0", TotalRows, "byte count past the end of the file");
+    damagedCount(original, blocks, 1, std::to_string(bytes + 100), TotalRows, "byte count into the next block");
+    damagedCount(original, blocks, 1, std::to_string(bytes - 100), TotalRows, "byte count short of the block");
+    damagedCount(original, blocks, blocks.size() - 1, count + "0", TotalRows, "last block's count damaged");
+
+    std::string text = original;
+    text[blocks[1].payloadStart + 10] ^= 0x20;
+    writeFile(text);
+    check(readRows(corrupt, inOrder) == TotalRows - blocks[1].rows && corrupt == 1 && inOrder,
+          "a flipped payload byte loses only its block");
+
+    std::remove(Path);
+    std::printf(failures ? "%d checks failed\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
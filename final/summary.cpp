@@ -0,0 +1,58 @@
+#include "summary.h"
+#include "taskmanager.h"
+#include <atomic>
+
+static bool sameSession(const Task::Session& a, const Task::Session& b) {
+    return a.startTime == b.startTime && a.endTime == b.endTime && a.duration == b.duration;
+}
+
+void refreshSnapshot(TaskManager& manager, std::vector<TaskSnapshot>& snapshot) {
+    snapshot.resize(manager.getCount());
+    for (int i = 0; i < manager.getCount(); ++i) {
+        Task* t = manager.getTaskAt(i);
+        TaskSnapshot& copy = snapshot[i];
+        const std::vector<Task::Session>& live = t->getSessions();  // Job must not read vectors the GUI may append to
+        size_t have = copy.sessions.size();
+        bool appended = copy.task == t && live.size() >= have &&
+                        (have == 0 || sameSession(live[have - 1], copy.sessions.back()));
+        if (!appended) copy.sessions.clear();  // Slot now holds another task, or its history was rewritten
+        copy.task = t;
+        copy.name = t->getName();
+        copy.sessions.insert(copy.sessions.end(), live.begin() + (std::ptrdiff_t)copy.sessions.size(), live.end());
+    }
+}
+
+SummaryResult computeDailySummary(const std::vector<TaskSnapshot>& tasks, const struct tm& date,
+                                  Executor& executor) {
+    SummaryResult result;
+    result.date = date;
+
+    // Bounds of the selected local day; comparing timestamps avoids localtime() per session
+    struct tm day = date;
+    day.tm_hour = 0;
+    day.tm_min = 0;
+    day.tm_sec = 0;
+    day.tm_isdst = -1;
+    time_t dayStart = mktime(&day);
+    day.tm_mday += 1;
+    day.tm_isdst = -1;
+    time_t dayEnd = mktime(&day);
+
+    for (const TaskSnapshot& task : tasks) {
+        std::atomic<int64_t> daily(0);
+        executor.parallelFor(0, task.sessions.size(), 1 << 16, [&](size_t from, size_t to) {
+            int64_t sum = 0;
+            auto session = task.sessions.begin() + (std::ptrdiff_t)from;
+            for (size_t i = from; i < to; ++i, ++session) {
+                if (session->startTime >= dayStart && session->startTime < dayEnd) {
+                    sum += session->duration;  // Session started on the selected date
+                }
+            }
+            daily += sum;  // One atomic add per chunk
+        });
+        result.names.push_back(task.name);
+        result.daily.push_back(daily);
+        result.dailyTotal += daily;
+    }
+    return result;
+}
@@ -0,0 +1,39 @@
+#pragma once
+/*
+ * summary.h ― Daily/cumulative time summary computed off the render thread.
+ * The GUI keeps a snapshot of the tasks' finished sessions, and
+ * computeDailySummary() sums the sessions that started on the selected
+ * local date with a parallel-for over each task's session range on the
+ * shared Executor. refreshSnapshot() copies only the sessions appended
+ * since its last call, so the render thread does not copy the whole
+ * history on every Stop; a task's history is copied again only when it was
+ * rewritten (reset, reload, deleted task). Time from a session still in
+ * progress is not part of the snapshot; the GUI adds it live each frame.
+ */
+
+#include "executor.h"
+#include "task.h"
+#include <ctime>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+class TaskManager;
+
+struct TaskSnapshot {
+    const Task* task = nullptr;          // Task the sessions were copied from
+    std::string name;                    // Task name at snapshot time
+    std::deque<Task::Session> sessions;  // Finished sessions; appending never moves those already copied
+};
+
+struct SummaryResult {
+    std::vector<std::string> names;      // Task names, in task order
+    std::vector<int64_t> daily;          // Seconds logged on the selected date per task
+    int64_t dailyTotal = 0;              // Sum of daily over all tasks
+    struct tm date = {};                 // Date the summary was computed for
+};
+
+void refreshSnapshot(TaskManager& manager, std::vector<TaskSnapshot>& snapshot); // Copies new sessions; no job may read snapshot meanwhile
+SummaryResult computeDailySummary(const std::vector<TaskSnapshot>& tasks, const struct tm& date,
+                                  Executor& executor); // Parallel sum of each task's sessions on the date
@@ -39,6 +39,7 @@ void Task::stop() {
     long long duration = endTime - startTime;  // Calculate elapsed time
     totalDuration += duration;  // Add elapsed time to total
     sessions.push_back({startTime, endTime, duration});  // Log the session
+    stats.add(startTime, duration);  // Update running statistics
     startTime = 0;  // Reset start time to indicate stopped
 }
 
@@ -48,6 +49,7 @@ void Task::pause() {
         long long duration = endTime - startTime;  // Calculate elapsed time
         totalDuration += duration;  // Add elapsed time to total
         sessions.push_back({startTime, endTime, duration});  // Log the session
+        stats.add(startTime, duration);  // Update running statistics
         startTime = 0;  // Reset start time to indicate paused
     }
 }
@@ -56,10 +58,12 @@ void Task::reset() {
     totalDuration = 0;  // Reset accumulated duration to zero
     startTime = 0;      // Stop the timer
     sessions.clear();   // Clear all logged sessions
+    stats.clear();      // Forget statistics along with the sessions
 }
 
 void Task::addSession(time_t start, time_t end, long long duration) {
     sessions.push_back({start, end, duration});  // Add the provided session to the log
+    stats.add(start, duration);  // Update running statistics
 }
 
 /* ── Status & Accessors ──────────────────────────────────── */
@@ -75,6 +79,10 @@ long long Task::getTotalDuration() const {
     return totalDuration;  // Return total duration if not running
 }
 
+long long Task::getFinishedDuration() const {
+    return totalDuration;  // Running session excluded, as toCSV() does
+}
+
 long long Task::getLastStartTime() const {
     return startTime;  // Return the last recorded start time
 }
@@ -83,6 +91,10 @@ const std::vector<Task::Session>& Task::getSessions() const {
     return sessions;  // Return a const reference to the session vector
 }
 
+const SessionStats& Task::getStats() const {
+    return stats;  // Return the incrementally maintained statistics
+}
+
 /* ── Metadata ────────────────────────────────────────────── */
 
 void Task::rename(const std::string& newName) {
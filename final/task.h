@@ -5,9 +5,11 @@
  * history of session logs. It provides methods to manage task timing (start, stop,
  * pause, reset), retrieve status, modify metadata, and serialize data for storage.
  * The Session struct within the class tracks individual work sessions with start
- * time, end time, and duration.
+ * time, end time, and duration. Every logged session also feeds a SessionStats
+ * summary so percentiles and streaks never require rescanning the history.
  */
 
+#include "sessionstats.h"
 #include <string>
 #include <vector>
 
@@ -24,6 +26,7 @@ private:
     long long totalDuration;   // Total accumulated time in seconds across all sessions
     long long startTime;       // Last start time in epoch seconds (0 if not running)
     std::vector<Session> sessions; // Vector storing all logged sessions for the task
+    SessionStats stats;        // Incrementally maintained analytics over the sessions
 
 public:
     /* ── Constructors ───────────────────────────────────────── */
@@ -41,8 +44,10 @@ public:
     /* ── Quick Status Helpers ───────────────────────────────── */
     bool isRunning() const;              // Returns true if the task timer is currently active
     long long getTotalDuration() const;  // Returns the total duration, including current session if running
+    long long getFinishedDuration() const;  // Returns the total of finished sessions only (what tasks.csv stores)
     long long getLastStartTime() const;  // Returns the last start time (0 if timer is stopped)
     const std::vector<Session>& getSessions() const; // Returns a const reference to the session vector
+    const SessionStats& getStats() const; // Returns streaming statistics (median/p90, streaks) for the sessions
 
     /* ── Metadata Helpers ───────────────────────────────────── */
     void rename(const std::string& newName); // Updates the task name to a new value
@@ -1,7 +1,9 @@
 #include "taskmanager.h"
+#include "sessionstore.h"
+#include "../common/csvschema.h"
 #include <iostream>
 #include <fstream>
-#include <sstream>
+#include <ctime>
 
 TaskManager::TaskManager() {
     count = 0;  // Initialize the task count to zero
@@ -40,10 +42,25 @@ int TaskManager::binarySearch(std::string target) {
     return -1;  // Return -1 if target not found
 }
 
+// A tasks.csv row; the name points into the line being read or written
+struct TaskLine {
+    std::string_view name;
+    long long duration;
+};
+
+// Names may contain commas: the duration is split off from the right
+static const CsvSchema taskSchema(CsvField<&TaskLine::name, CsvCommaText>("name"),
+                                  CsvField<&TaskLine::duration>("duration"));
+
 void TaskManager::saveToFile(std::string filename) {
     std::ofstream outFile(filename);  // Open file for writing
+    std::string line;
     for (int i = 0; i < count; i++) {
-        outFile << tasks[i]->toCSV() << std::endl;  // Write each task's CSV data
+        std::string name = tasks[i]->getName();
+        line.resize(name.size() + 32);  // Room for the duration, comma and newline
+        TaskLine row = {name, tasks[i]->getFinishedDuration()};
+        char* end = taskSchema.write(&line[0], &line[0] + line.size(), row);
+        outFile.write(line.data(), end - line.data());  // Write each task's CSV data
     }
     outFile.close();  // Close the file
 }
@@ -51,55 +68,80 @@ void TaskManager::saveToFile(std::string filename) {
 void TaskManager::loadFromFile(std::string filename) {
     std::ifstream inFile(filename);  // Open file for reading
     std::string line;
+    int lineNumber = 0;
     while (getline(inFile, line)) {
-        size_t commaPos = line.find(',');
-        if (commaPos != std::string::npos) {
-            std::string name = line.substr(0, commaPos);
-            long long duration = std::stoll(line.substr(commaPos + 1));
-            if (count < 10) {
-                tasks[count] = new Task(name, duration);  // Create task from file data
-                count++;
-            }
+        lineNumber++;
+        if (line.empty() || line == "\r") continue;  // Blank line
+        TaskLine row;
+        int failed = taskSchema.parse(line.data(), line.data() + line.size(), row);
+        if (failed >= 0) {
+            std::cerr << filename << " line " << lineNumber << ": missing or malformed "
+                      << taskSchema.name((size_t)failed) << ", row skipped\n";
+            continue;
+        }
+        if (count < 10) {
+            tasks[count] = new Task(std::string(row.name), row.duration);  // Create task from file data
+            count++;
         }
     }
     inFile.close();  // Close the file
 }
 
 void TaskManager::saveSessionsToFile(std::string filename) {
-    std::ofstream outFile(filename);  // Open file for writing
+    SessionWriter writer(filename);  // Checksummed blocks into a temporary file
+    // Write sessions of all tasks ordered by start time (k-way merge of the per-task logs)
+    // so session files from several devices can be stream-merged later.
+    size_t next[10] = {0};  // Next unwritten session of each task
+    while (true) {
+        int best = -1;
+        for (int i = 0; i < count; i++) {
+            const auto& sessions = tasks[i]->getSessions();
+            if (next[i] < sessions.size() &&
+                (best == -1 || sessions[next[i]].startTime < tasks[best]->getSessions()[next[best]].startTime)) {
+                best = i;  // Earliest pending session so far
+            }
+        }
+        if (best == -1) break;  // Every session written
+        Task* t = tasks[best];
+        const Task::Session& session = t->getSessions()[next[best]++];
+        writer.write(t->getName(), session.startTime, session.endTime, session.duration);
+    }
+    if (!writer.commit()) {  // Old file stays in place if anything failed
+        std::cerr << "Failed to save " << filename << ".\n";
+    }
+}
+
+bool TaskManager::exportSessionReport(const std::string& filename, ReportFormat format) const {
+    ReportWriter out;  // Buffered; one write per megabyte instead of one per line
+    if (!out.open(filename)) {
+        std::cerr << "Cannot write " << filename << ".\n";
+        return false;
+    }
+    out.begin(format, {{"task", 16}, {"start", 10, true}, {"end", 10, true}, {"seconds", 0, true}});
     for (int i = 0; i < count; i++) {
-        Task* t = tasks[i];
-        const auto& sessions = t->getSessions();
-        for (const auto& session : sessions) {
-            outFile << t->getName() << ","  // Write task name
-                    << session.startTime << ","  // Write start time
-                    << session.endTime << ","    // Write end time
-                    << session.duration << std::endl;  // Write duration
+        for (const Task::Session& session : tasks[i]->getSessions()) {
+            out.text(tasks[i]->getName());
+            out.integer((long long)session.startTime);
+            out.integer((long long)session.endTime);
+            out.integer(session.duration);
+            out.endRow();
         }
     }
-    outFile.close();  // Close the file
+    return out.close();
 }
 
 void TaskManager::loadSessionsFromFile(std::string filename) {
-    std::ifstream inFile(filename);  // Open file for reading
-    std::string line;
-    while (getline(inFile, line)) {
-        std::stringstream ss(line);  // Parse line into stream
-        std::string name;
-        time_t startTime, endTime;
-        long long duration;
-        std::string token;
-        if (getline(ss, name, ',') &&  // Extract name
-            getline(ss, token, ',') && (startTime = std::stoll(token)) &&  // Extract start time
-            getline(ss, token, ',') && (endTime = std::stoll(token)) &&    // Extract end time
-            getline(ss, token) && (duration = std::stoll(token))) {
-            int index = binarySearch(name);  // Find task index
-            if (index != -1) {
-                tasks[index]->addSession(startTime, endTime, duration);  // Add session to task
-            }
+    SessionReader reader(filename);  // Verifies checksums; also reads plain CSV files
+    SessionRow row;
+    while (reader.next(row)) {
+        int index = binarySearch(row.name);  // Find task index
+        if (index != -1) {
+            tasks[index]->addSession(row.start, row.end, row.duration);  // Add session to task
         }
     }
-    inFile.close();  // Close the file
+    for (const std::string& problem : reader.getProblems()) {
+        std::cerr << filename << ": " << problem << "\n";  // Report what was skipped
+    }
 }
 
 Task* TaskManager::getTaskAt(int index) {
@@ -120,6 +162,7 @@ void TaskManager::addDurationToTask(const std::string& name, long long duration)
     if (index != -1) {
         Task* t = tasks[index];
         long long total = t->getTotalDuration();
+        cancelTimers(index);  // Scheduled actions hold the old task pointer
         delete t;  // Free old task object
         tasks[index] = new Task(name, total + duration);  // Create new task with updated duration
     }
@@ -133,11 +176,21 @@ void TaskManager::showSummary() const {
     }
 }
 
+SessionStats TaskManager::groupStats() const {
+    SessionStats total;
+    for (int i = 0; i < count; i++) {
+        total.merge(tasks[i]->getStats());  // Sketches merge without touching the sessions
+    }
+    return total;
+}
+
 void TaskManager::deleteTask(int index) {
     if (index >= 0 && index < count) {
+        cancelTimers(index);  // Drop scheduled actions that point at this task
         delete tasks[index];  // Free the task object
         for (int i = index; i < count - 1; ++i) {
             tasks[i] = tasks[i + 1];  // Shift remaining tasks
+            taskTimers[i].swap(taskTimers[i + 1]);  // Keep timer ids aligned with their task
         }
         count--;  // Decrease task count
         saveToFile("tasks.csv");  // Save updated task list
@@ -154,3 +207,138 @@ bool TaskManager::renameTask(int index, const std::string& newName) {
     }
     return false;  // Indicate failure
 }
+
+/* ── Scheduled Actions ───────────────────────────────────── */
+
+int TaskManager::indexOf(const Task* task) const {
+    for (int i = 0; i < count; i++) {
+        if (tasks[i] == task) return i;  // Task still lives in this slot
+    }
+    return -1;  // Task was deleted or replaced
+}
+
+void TaskManager::trackTimer(int index, TimerWheel::TimerId id) {
+    std::vector<TimerWheel::TimerId>& ids = taskTimers[index];
+    size_t kept = 0;
+    for (size_t i = 0; i < ids.size(); i++) {
+        if (timers.isPending(ids[i])) ids[kept++] = ids[i];  // Forget timers that already fired
+    }
+    ids.resize(kept);
+    ids.push_back(id);
+}
+
+long long TaskManager::secondsToday(const Task* task) const {
+    time_t now = time(nullptr);
+    struct tm midnight = *localtime(&now);
+    midnight.tm_hour = 0;
+    midnight.tm_min = 0;
+    midnight.tm_sec = 0;
+    time_t dayStart = mktime(&midnight);  // Local midnight of the wheel's current day
+    long long total = 0;
+    for (const auto& session : task->getSessions()) {
+        if (session.startTime >= dayStart) total += session.duration;  // Sessions logged today
+    }
+    if (task->isRunning()) {
+        long long from = task->getLastStartTime();
+        if (from < dayStart) from = dayStart;
+        total += now - from;  // Include the session in progress
+    }
+    return total;
+}
+
+void TaskManager::scheduleAutoStop(int index, long long seconds) {
+    Task* t = getTaskAt(index);
+    if (!t) return;
+    t->start();  // Auto-stop implies the task is running
+    TimerWheel::TimerId id = timers.schedule(time(nullptr) + seconds, [this, t]() {
+        if (indexOf(t) == -1 || !t->isRunning()) return;  // Task gone or stopped by hand
+        t->stop();
+        std::cout << "Auto-stopped " << t->getName() << ".\n";
+    });
+    trackTimer(index, id);
+}
+
+void TaskManager::schedulePomodoroPhase(Task* task, long long workSeconds, long long breakSeconds,
+                                        int cyclesLeft, bool working) {
+    int index = indexOf(task);
+    if (index == -1) return;
+    long long delay = working ? workSeconds : breakSeconds;
+    long long startedAt = task->getLastStartTime();  // What the cycle left; any other state is the user's
+    size_t logged = task->getSessions().size();
+    TimerWheel::TimerId id = timers.schedule(time(nullptr) + delay, [=]() {
+        if (indexOf(task) == -1) return;  // Task deleted mid-cycle
+        if (task->getLastStartTime() != startedAt || task->getSessions().size() != logged) {
+            std::cout << "Pomodoro: ended for " << task->getName() << " (timer changed by hand).\n";
+            return;  // Stopped, paused, restarted or reset since this phase began
+        }
+        if (working) {
+            task->pause();  // Work block finished: log it as a session
+            if (cyclesLeft > 1) {
+                std::cout << "Pomodoro: break time for " << task->getName() << ".\n";
+                schedulePomodoroPhase(task, workSeconds, breakSeconds, cyclesLeft, false);
+            } else {
+                std::cout << "Pomodoro: all cycles done for " << task->getName() << ".\n";
+            }
+        } else {
+            task->start();  // Break over: resume work
+            std::cout << "Pomodoro: back to " << task->getName() << ".\n";
+            schedulePomodoroPhase(task, workSeconds, breakSeconds, cyclesLeft - 1, true);
+        }
+    });
+    trackTimer(index, id);
+}
+
+void TaskManager::schedulePomodoro(int index, long long workSeconds, long long breakSeconds, int cycles) {
+    Task* t = getTaskAt(index);
+    if (!t || cycles <= 0) return;
+    t->start();  // First work block begins immediately
+    schedulePomodoroPhase(t, workSeconds, breakSeconds, cycles, true);
+}
+
+void TaskManager::scheduleBudgetCheck(Task* task, long long budgetSeconds, time_t when) {
+    int index = indexOf(task);
+    if (index == -1) return;
+    TimerWheel::TimerId id = timers.schedule(when, [this, task, budgetSeconds]() {
+        if (indexOf(task) == -1) return;
+        time_t now = time(nullptr);
+        long long used = secondsToday(task);
+        if (used >= budgetSeconds) {
+            std::cout << "Budget alert: " << task->getName() << " used "
+                      << used << "s of " << budgetSeconds << "s today.\n";
+            struct tm next = *localtime(&now);
+            next.tm_mday += 1;  // Re-arm for tomorrow
+            next.tm_hour = 0;
+            next.tm_min = 0;
+            next.tm_sec = 0;
+            scheduleBudgetCheck(task, budgetSeconds, mktime(&next));
+        } else {
+            long long remaining = budgetSeconds - used;
+            // Earliest moment the budget could run out; poll slowly while the task is idle
+            scheduleBudgetCheck(task, budgetSeconds, now + (remaining < 60 ? 60 : remaining));
+        }
+    });
+    trackTimer(index, id);
+}
+
+void TaskManager::scheduleBudgetAlert(int index, long long budgetSeconds) {
+    Task* t = getTaskAt(index);
+    if (!t || budgetSeconds <= 0) return;
+    long long remaining = budgetSeconds - secondsToday(t);
+    scheduleBudgetCheck(t, budgetSeconds, time(nullptr) + (remaining < 1 ? 1 : remaining));
+}
+
+void TaskManager::cancelTimers(int index) {
+    if (index < 0 || index >= count) return;
+    for (TimerWheel::TimerId id : taskTimers[index]) {
+        timers.cancel(id);  // O(1) per timer; stale ids are ignored
+    }
+    taskTimers[index].clear();
+}
+
+int TaskManager::tick(time_t now) {
+    return timers.advance(now);  // Only due slots are visited, never the task list
+}
+
+int TaskManager::pendingTimers() const {
+    return timers.pendingCount();  // Timers still waiting across all tasks
+}
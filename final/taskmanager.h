@@ -3,16 +3,30 @@
  * taskmanager.h ― Manages a collection of tasks with file I/O and search capabilities.
  * This class handles a fixed array of up to 10 tasks, providing methods to add, delete,
  * rename, and display tasks. It also supports saving and loading task and session data
- * to/from CSV files, with a binary search for efficient task lookup.
+ * to/from CSV files, with a binary search for efficient task lookup. Scheduled
+ * actions (Pomodoro cycles, auto-stop deadlines, daily budget alerts) run on a
+ * shared timing wheel that the caller drains once per tick.
  */
 
 #include "task.h"
+#include "timerwheel.h"
+#include "../common/reportwriter.h"
 #include <string>
+#include <vector>
 
 class TaskManager {
 private:
     Task* tasks[10];  // Fixed-size array to hold task pointers
     int count;        // Number of tasks currently in the array
+    TimerWheel timers; // Pending scheduled actions for all tasks
+    std::vector<TimerWheel::TimerId> taskTimers[10]; // Timer ids owned by each task slot
+
+    int indexOf(const Task* task) const;        // Returns the slot holding a task pointer (-1 if gone)
+    void trackTimer(int index, TimerWheel::TimerId id); // Records a timer against a task slot
+    void schedulePomodoroPhase(Task* task, long long workSeconds, long long breakSeconds,
+                               int cyclesLeft, bool working); // Queues the next Pomodoro transition
+    void scheduleBudgetCheck(Task* task, long long budgetSeconds, time_t when); // Queues a budget re-check
+    long long secondsToday(const Task* task) const; // Time logged on a task since local midnight
 
 public:
     TaskManager();                        // Constructor, initializes task count to zero
@@ -25,13 +39,23 @@ public:
     void loadFromFile(std::string filename); // Loads tasks from a specified CSV file
     void saveSessionsToFile(std::string filename); // Saves all session logs to a specified CSV file
     void loadSessionsFromFile(std::string filename); // Loads session logs from a specified CSV file
+    bool exportSessionReport(const std::string& filename, ReportFormat format) const; // Writes every session as CSV/TSV/JSONL/text
     Task* getTaskAt(int index);           // Returns a pointer to the task at the given index
     int getCount() const;                 // Returns the current number of tasks
 
     void logSession(const std::string& name, long long duration); // Logs a duration to the specified task
     void showSummary() const;             // Displays a summary of all tasks' total durations
+    SessionStats groupStats() const;      // Merges every task's session statistics into group totals
     void addDurationToTask(const std::string& name, long long duration); // Adds duration to an existing task
 
     void deleteTask(int index);                 // Deletes the task at the specified index
     bool renameTask(int index, const std::string& newName); // Renames the task at the specified index
+
+    /* ── Scheduled Actions ─────────────────────────────────── */
+    void scheduleAutoStop(int index, long long seconds); // Starts the task and stops it after the given time
+    void schedulePomodoro(int index, long long workSeconds, long long breakSeconds, int cycles); // Runs work/break cycles until the timer is changed by hand
+    void scheduleBudgetAlert(int index, long long budgetSeconds); // Warns once the task exceeds a daily budget
+    void cancelTimers(int index);         // Cancels every scheduled action of the task at the index
+    int tick(time_t now);                 // Fires due actions; returns how many ran (caller saves if > 0)
+    int pendingTimers() const;            // Returns the number of scheduled actions still waiting
 };
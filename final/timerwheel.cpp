@@ -0,0 +1,158 @@
+#include "timerwheel.h"
+#include <utility>
+
+/* ── Construction ────────────────────────────────────────── */
+
+TimerWheel::TimerWheel(time_t start) {
+    now = start != 0 ? start : time(nullptr);  // Position the wheel at the requested time
+    pending = 0;                               // No timers yet
+    for (int i = 0; i <= FiringList; ++i) {
+        heads[i] = -1;  // Every slot list starts empty
+    }
+}
+
+/* ── Intrusive List Helpers ──────────────────────────────── */
+
+void TimerWheel::link(int index, int list) {
+    Node& n = nodes[index];
+    n.list = list;           // Remember which list owns the node
+    n.prev = -1;             // New head has no predecessor
+    n.next = heads[list];    // Old head follows the new node
+    if (heads[list] != -1) nodes[heads[list]].prev = index;
+    heads[list] = index;     // Node becomes the new head
+}
+
+void TimerWheel::unlink(int index) {
+    Node& n = nodes[index];
+    if (n.prev != -1) nodes[n.prev].next = n.next;  // Bypass the node from the left
+    else heads[n.list] = n.next;                    // Or move the list head past it
+    if (n.next != -1) nodes[n.next].prev = n.prev;  // Bypass the node from the right
+    n.prev = n.next = -1;
+    n.list = -1;                                    // Node is no longer on any list
+}
+
+void TimerWheel::place(int index, bool cascading) {
+    time_t expires = nodes[index].expires;
+    long long delta = (long long)(expires - now);
+    if (delta < 0 || (delta == 0 && !cascading)) {
+        link(index, (int)((now + 1) & (SlotsPerLevel - 1)));  // Overdue: fire on the next tick
+        return;
+    }
+    for (int level = 0; level < Levels; ++level) {
+        if (delta < (1LL << (LevelBits * (level + 1)))) {
+            int slot = (int)((expires >> (LevelBits * level)) & (SlotsPerLevel - 1));
+            link(index, level * SlotsPerLevel + slot);  // First level whose range covers the delay
+            return;
+        }
+    }
+    // Beyond the wheel's range: park in the top-level slot that cascades last
+    int top = Levels - 1;
+    int slot = (int)(((now >> (LevelBits * top)) + SlotsPerLevel - 1) & (SlotsPerLevel - 1));
+    link(index, top * SlotsPerLevel + slot);
+}
+
+void TimerWheel::release(int index) {
+    Node& n = nodes[index];
+    n.callback = nullptr;  // Drop captured state right away
+    n.generation++;        // Invalidate every outstanding id for this node
+    if (n.generation == 0) n.generation = 1;  // Keep ids distinct from InvalidTimer
+    freeNodes.push_back(index);
+}
+
+/* ── Scheduling ──────────────────────────────────────────── */
+
+TimerWheel::TimerId TimerWheel::schedule(time_t when, Callback callback) {
+    int index;
+    if (!freeNodes.empty()) {
+        index = freeNodes.back();  // Reuse a released node
+        freeNodes.pop_back();
+    } else {
+        index = (int)nodes.size();  // Grow the pool by one node
+        nodes.push_back({0, nullptr, -1, -1, -1, 1});
+    }
+    nodes[index].expires = when;
+    nodes[index].callback = std::move(callback);
+    place(index, false);  // O(1): slot is computed directly from the expiry time
+    pending++;
+    return ((TimerId)nodes[index].generation << 32) | (std::uint32_t)index;
+}
+
+TimerWheel::TimerId TimerWheel::scheduleIn(long long seconds, Callback callback) {
+    return schedule(now + (time_t)seconds, std::move(callback));  // Relative to the wheel's clock
+}
+
+bool TimerWheel::isPending(TimerId id) const {
+    std::uint32_t index = (std::uint32_t)(id & 0xffffffffu);
+    std::uint32_t generation = (std::uint32_t)(id >> 32);
+    if (index >= nodes.size()) return false;  // Id never issued by this wheel
+    const Node& n = nodes[index];
+    return n.generation == generation && n.list != -1;  // Same incarnation and still linked
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    if (!isPending(id)) return false;  // Already fired, cancelled or unknown
+    int index = (int)(id & 0xffffffffu);
+    unlink(index);   // O(1) removal from its slot list
+    release(index);
+    pending--;
+    return true;
+}
+
+/* ── Advancing ───────────────────────────────────────────── */
+
+void TimerWheel::cascade(int level, int slot) {
+    int list = level * SlotsPerLevel + slot;
+    while (heads[list] != -1) {
+        int index = heads[list];
+        unlink(index);
+        place(index, true);  // Lands in a lower level now that it is closer
+    }
+}
+
+int TimerWheel::fireDue() {
+    int slot = (int)(now & (SlotsPerLevel - 1));
+    while (heads[slot] != -1) {
+        int index = heads[slot];
+        unlink(index);
+        link(index, FiringList);  // Stage so callbacks may cancel timers that are due this tick
+    }
+    int fired = 0;
+    while (heads[FiringList] != -1) {
+        int index = heads[FiringList];
+        unlink(index);
+        Callback callback = std::move(nodes[index].callback);
+        release(index);  // Free first so the callback may reschedule freely
+        pending--;
+        if (callback) callback();
+        fired++;
+    }
+    return fired;
+}
+
+int TimerWheel::advance(time_t to) {
+    int fired = 0;
+    while (now < to) {
+        if (pending == 0) {
+            now = to;  // Nothing scheduled: jump straight to the target time
+            break;
+        }
+        now++;
+        // Cascade upper levels whenever the level below wraps around
+        for (int level = 1; level < Levels; ++level) {
+            if ((now & ((1LL << (LevelBits * level)) - 1)) != 0) break;
+            cascade(level, (int)((now >> (LevelBits * level)) & (SlotsPerLevel - 1)));
+        }
+        fired += fireDue();
+    }
+    return fired;
+}
+
+/* ── Accessors ───────────────────────────────────────────── */
+
+time_t TimerWheel::currentTime() const {
+    return now;  // Time of the last advance
+}
+
+int TimerWheel::pendingCount() const {
+    return pending;  // Number of timers waiting to fire
+}
@@ -0,0 +1,63 @@
+#pragma once
+/*
+ * timerwheel.h ― Hierarchical timing wheel for scheduled task actions.
+ * Timers are kept in four levels of 64 slots at one-second resolution, so a
+ * timer up to ~194 days away lands in a slot computed from its expiry time.
+ * Scheduling and cancelling are O(1) (intrusive lists over a node pool), and
+ * advancing the wheel only touches the slots that actually come due, which
+ * lets the render loop or headless loop drain timers every tick without
+ * scanning tasks. Timers further out than the top level are parked in the
+ * farthest top-level slot and re-placed when that slot cascades.
+ */
+
+#include <ctime>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class TimerWheel {
+public:
+    using TimerId = std::uint64_t;           // Generation (high 32 bits) + node index (low 32 bits)
+    using Callback = std::function<void()>;  // Action run when the timer expires
+    static const TimerId InvalidTimer = 0;   // Never returned by schedule()
+
+private:
+    static const int LevelBits = 6;                 // 64 slots per level
+    static const int SlotsPerLevel = 1 << LevelBits;
+    static const int Levels = 4;                    // 64^4 seconds of range before parking
+    static const int FiringList = Levels * SlotsPerLevel; // Extra list holding timers being fired
+
+    struct Node {
+        time_t expires;          // Absolute expiry time in epoch seconds
+        Callback callback;       // Action to run on expiry
+        int prev;                // Previous node in the slot list (-1 if head)
+        int next;                // Next node in the slot list (-1 if tail)
+        int list;                // Slot list this node is linked into (-1 if free)
+        std::uint32_t generation; // Bumped on every reuse so stale ids are rejected
+    };
+
+    std::vector<Node> nodes;     // Node pool, indexed by the low half of a TimerId
+    std::vector<int> freeNodes;  // Indices of unused nodes in the pool
+    int heads[FiringList + 1];   // Head node of every slot list (-1 if empty)
+    time_t now;                  // Last time the wheel was advanced to
+    int pending;                 // Number of timers currently scheduled
+
+    void link(int index, int list);     // Pushes a node onto the front of a slot list
+    void unlink(int index);             // Removes a node from whatever list holds it
+    void place(int index, bool cascading); // Links a node into the slot matching its expiry
+    void release(int index);            // Returns a node to the free pool
+    void cascade(int level, int slot);  // Re-places every timer of a higher-level slot
+    int fireDue();                      // Runs every timer in the current level-0 slot
+
+public:
+    explicit TimerWheel(time_t start = 0);  // Creates an empty wheel positioned at start (0 = now)
+
+    TimerId schedule(time_t when, Callback callback);       // Adds a timer firing at an absolute time
+    TimerId scheduleIn(long long seconds, Callback callback); // Adds a timer firing seconds from now
+    bool cancel(TimerId id);          // Cancels a pending timer; false if it already fired or was cancelled
+    bool isPending(TimerId id) const; // Returns true if the timer is still waiting to fire
+    int advance(time_t to);           // Moves the wheel forward, firing due timers; returns how many fired
+
+    time_t currentTime() const;       // Returns the time the wheel was last advanced to
+    int pendingCount() const;         // Returns the number of scheduled timers
+};
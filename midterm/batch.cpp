@@ -0,0 +1,88 @@
+#include "batch.h"
+using namespace std;
+
+// Print an error for a line of the script
+static void reportError(ostream& out, long long line, const string& message, BatchStats& stats) {
+    out << "error\t" << line << '\t' << message << '\n';
+    stats.errors++;
+}
+
+// Save the tasks and report it as the result of a line
+static void save(TaskManager& manager, ostream& out, const BatchOptions& options, long long line,
+                 BatchStats& stats) {
+    if (manager.saveToFile(options.saveFile)) {
+        out << "saved\t" << line << '\t' << manager.size() << '\n';
+        stats.saves++;
+    } else {
+        reportError(out, line, "cannot write " + options.saveFile, stats);
+    }
+}
+
+// Print one task
+static void showTask(Task& task, ostream& out) {
+    out << "task\t" << task.getName() << '\t' << task.getDuration() << '\t'
+        << (task.isRunning() ? "running" : "stopped") << '\n';
+}
+
+// Run one command; name is everything after the first space
+static void runCommand(TaskManager& manager, const string& command, const string& name, ostream& out,
+                       const BatchOptions& options, long long line, BatchStats& stats) {
+    if (command == "add") {
+        if (name.empty()) reportError(out, line, "missing task name", stats);
+        else if (name.find('\t') != string::npos) reportError(out, line, "task names cannot contain tabs", stats);
+        else if (!manager.addTask(name)) reportError(out, line, "task exists: " + name, stats);
+        else out << "ok\t" << line << "\tadd\t" << name << '\n';
+        return;
+    }
+    if (command == "show" && name.empty()) {
+        for (int i = 0; i < manager.size(); i++) showTask(*manager.getTaskAt(i), out);
+        return;
+    }
+    if (command == "save") {
+        save(manager, out, options, line, stats);
+        return;
+    }
+    if (command != "start" && command != "stop" && command != "show") {
+        reportError(out, line, "unknown command: " + command, stats);
+        return;
+    }
+
+    Task* task = manager.getTaskAt(manager.findTask(name));
+    if (!task) {
+        reportError(out, line, "no such task: " + name, stats);
+    } else if (command == "show") {
+        showTask(*task, out);
+    } else if (command == "start") {
+        if (task->start()) out << "ok\t" << line << "\tstart\t" << name << '\n';
+        else reportError(out, line, "already running: " + name, stats);
+    } else {
+        if (task->stop()) out << "ok\t" << line << "\tstop\t" << name << '\n';
+        else reportError(out, line, "not running: " + name, stats);
+    }
+}
+
+// Run a whole script
+bool runBatch(TaskManager& manager, istream& in, ostream& out, const BatchOptions& options, BatchStats& stats) {
+    string text, command, name;
+    long long line = 0;
+    while (getline(in, text)) {
+        line++;
+        if (!text.empty() && text.back() == '\r') text.pop_back(); // Scripts written on Windows
+        if (text.empty() || text[0] == '#') continue;
+
+        size_t space = text.find(' ');
+        command.assign(text, 0, space);
+        if (space == string::npos) name.clear();
+        else name.assign(text, space + 1, string::npos);
+        runCommand(manager, command, name, out, options, line, stats);
+
+        stats.commands++;
+        if (options.checkpoint > 0 && stats.commands % options.checkpoint == 0 && command != "save") {
+            save(manager, out, options, line, stats);
+        }
+    }
+    save(manager, out, options, line, stats);
+    out << "done\t" << stats.commands << '\t' << stats.errors << '\t' << stats.saves << '\n';
+    out.flush();
+    return stats.errors == 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <iostream>
+#include "taskmanager.h"
+
+// Batch mode reads one command per line:
+//
+//     add <name>      start <name>      stop <name>
+//     show            show <name>       save
+//
+// Blank lines and lines starting with # are skipped. Each command prints one tab-separated line:
+//
+//     ok      <line>  <command>  <name>
+//     task    <name>  <seconds>  running|stopped      (show)
+//     saved   <line>  <tasks>
+//     error   <line>  <message>
+//
+// and the run ends with "done <commands> <errors> <saves>". Tasks are saved once at the end, after
+// every "save" command, and every checkpoint commands if checkpoint is above 0.
+
+struct BatchOptions {
+    string saveFile = "tasks.csv";  // Where tasks are saved
+    long long checkpoint = 0;       // Save after this many commands (0: only at the end)
+};
+
+struct BatchStats {
+    long long commands = 0;         // Commands run (blank and comment lines not counted)
+    long long errors = 0;           // Commands that failed, and failed saves
+    long long saves = 0;            // Successful saves
+};
+
+// Runs every command from in, printing results to out; false if any command or save failed
+bool runBatch(TaskManager& manager, istream& in, ostream& out, const BatchOptions& options, BatchStats& stats);
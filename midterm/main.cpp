@@ -1,11 +1,44 @@
 #include <iostream>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include "batch.h"
 #include "taskmanager.h"
 using namespace std;
 
-int main() {
+// Build: g++ -std=c++17 main.cpp task.cpp taskmanager.cpp batch.cpp
+// Batch: ./a.out --batch script.txt [--checkpoint N]   (--batch - reads the script from stdin)
+
+int main(int argc, char** argv) {
     TaskManager manager;
     manager.loadFromFile("tasks.csv");
 
+    string script;
+    BatchOptions options;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--batch" && i + 1 < argc) {
+            script = argv[++i];
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            options.checkpoint = atoll(argv[++i]);
+        } else {
+            cerr << "Usage: " << argv[0] << " [--batch file|- [--checkpoint N]]\n";
+            return 2;
+        }
+    }
+
+    if (!script.empty()) {
+        ios::sync_with_stdio(false);
+        BatchStats stats;
+        if (script == "-") return runBatch(manager, cin, cout, options, stats) ? 0 : 1;
+        ifstream in(script);
+        if (!in) {
+            cerr << "Cannot open " << script << "\n";
+            return 2;
+        }
+        return runBatch(manager, in, cout, options, stats) ? 0 : 1;
+    }
+
     int choice;
     do {
         cout << "\n--- Task Timer Menu ---\n";
@@ -15,14 +48,16 @@ int main() {
         cout << "4. Stop Task Timer\n";
         cout << "5. Save and Exit\n";
         cout << "Choose an option: ";
-        cin >> choice;
+        if (!(cin >> choice)) break; // End of input saves too
         cin.ignore();
 
         if (choice == 1) {
             string name;
             cout << "Enter task name: ";
             getline(cin, name);
-            manager.addTask(name);
+            if (!manager.addTask(name)) {
+                cout << "A task needs a new, non-empty name.\n";
+            }
 
         } else if (choice == 2) {
             manager.showAllTasks();
@@ -31,30 +66,35 @@ int main() {
             string target;
             cout << "Enter task name to start timer: ";
             getline(cin, target);
-            int idx = manager.binarySearch(target);
-            if (idx != -1) {
-                manager.getTaskAt(idx)->start();
+            Task* task = manager.getTaskAt(manager.findTask(target));
+            if (!task) {
+                cout << "Task not found.\n";
+            } else if (task->start()) {
                 cout << "Timer started.\n";
             } else {
-                cout << "Task not found.\n";
+                cout << "Timer already running.\n";
             }
 
         } else if (choice == 4) {
             string target;
             cout << "Enter task name to stop timer: ";
             getline(cin, target);
-            int idx = manager.binarySearch(target);
-            if (idx != -1) {
-                manager.getTaskAt(idx)->stop();
+            Task* task = manager.getTaskAt(manager.findTask(target));
+            if (!task) {
+                cout << "Task not found.\n";
+            } else if (task->stop()) {
                 cout << "Timer stopped.\n";
             } else {
-                cout << "Task not found.\n";
+                cout << "Timer not started.\n";
             }
         }
 
     } while (choice != 5);
 
-    manager.saveToFile("tasks.csv");
+    if (!manager.saveToFile("tasks.csv")) {
+        cout << "Could not save tasks.csv\n";
+        return 1;
+    }
     cout << "Tasks saved. Goodbye!\n";
     return 0;
 }
@@ -24,20 +24,20 @@ Task::Task(string taskName, int duration) {
     startTime = 0;
 }
 
-// Start timer
-void Task::start() {
+// Start timer (starting it again while it runs would lose the time so far)
+bool Task::start() {
+    if (startTime != 0) return false;
     startTime = time(nullptr);
+    return true;
 }
 
 // Stop timer
-void Task::stop() {
-    if (startTime == 0) {
-        cout << "Timer not started.\n";
-        return;
-    }
+bool Task::stop() {
+    if (startTime == 0) return false;
     long long endTime = time(nullptr);
     totalDuration += (endTime - startTime);
     startTime = 0;
+    return true;
 }
 
 // Show info
@@ -54,3 +54,13 @@ string Task::toCSV() {
 string Task::getName() {
     return name;
 }
+
+// Get total time
+int Task::getDuration() {
+    return totalDuration;
+}
+
+// Check whether the timer is running
+bool Task::isRunning() {
+    return startTime != 0;
+}
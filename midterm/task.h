@@ -14,9 +14,11 @@ public:
     Task(string taskName);                 // Constructor with name
     Task(string taskName, int duration);   // Constructor with name + duration (for loading)
 
-    void start();                          // Start timer
-    void stop();                           // Stop timer
+    bool start();                          // Start timer; false if it is already running
+    bool stop();                           // Stop timer and add the time; false if not running
     void display();                        // Show info
     string toCSV();                        // Convert to CSV line
     string getName();                      // Return name
+    int getDuration();                     // Return total time in seconds
+    bool isRunning();                      // Return true between start() and stop()
 };
@@ -1,61 +1,54 @@
 #include <iostream>
 #include <fstream>
+#include <cstdio>
+#include <filesystem>
 #include "taskmanager.h"
 using namespace std;
 
 // Constructor
 TaskManager::TaskManager() {
-    count = 0;
-}
-
-// Destructor
-TaskManager::~TaskManager() {
-    for (int i = 0; i < count; i++) {
-        delete tasks[i];
-    }
 }
 
 // Add a task
-void TaskManager::addTask(string name) {
-    if (count >= 10) {
-        cout << "Task limit reached!\n";
-        return;
-    }
-    tasks[count] = new Task(name);
-    count++;
+bool TaskManager::addTask(string name) {
+    if (name.empty() || byName.count(name)) return false;
+    byName.emplace(name, (int)tasks.size());
+    tasks.emplace_back(name);
+    return true;
 }
 
 // Show all tasks
 void TaskManager::showAllTasks() {
-    for (int i = 0; i < count; i++) {
-        tasks[i]->display();
+    for (Task& task : tasks) {
+        task.display();
     }
 }
 
-// Binary search
-int TaskManager::binarySearch(string target) {
-    int left = 0;
-    int right = count - 1;
-    while (left <= right) {
-        int mid = (left + right) / 2;
-        string midName = tasks[mid]->getName();
-        if (midName == target)
-            return mid;
-        if (midName < target)
-            left = mid + 1;
-        else
-            right = mid - 1;
-    }
-    return -1;
+// Find a task by name (hashed: tasks are kept in the order they were added, not sorted)
+int TaskManager::findTask(const string& target) {
+    auto it = byName.find(target);
+    return it == byName.end() ? -1 : it->second;
 }
 
-// Save to file
-void TaskManager::saveToFile(string filename) {
-    ofstream outFile(filename);
-    for (int i = 0; i < count; i++) {
-        outFile << tasks[i]->toCSV() << endl;
+// Save to file: written beside the old file and renamed over it, so a crash mid-save keeps the old one
+bool TaskManager::saveToFile(string filename) {
+    string temporary = filename + ".tmp";
+    ofstream outFile(temporary, ios::trunc);
+    for (Task& task : tasks) {
+        outFile << task.toCSV() << '\n';
     }
     outFile.close();
+    if (!outFile) {
+        remove(temporary.c_str());
+        return false;
+    }
+    error_code error;
+    filesystem::rename(temporary, filename, error);
+    if (error) {
+        remove(temporary.c_str());
+        return false;
+    }
+    return true;
 }
 
 // Load from file
@@ -63,13 +56,18 @@ void TaskManager::loadFromFile(string filename) {
     ifstream inFile(filename);
     string line;
     while (getline(inFile, line)) {
-        size_t commaPos = line.find(',');
+        size_t commaPos = line.rfind(','); // Names may contain commas; the duration cannot
         if (commaPos != string::npos) {
             string name = line.substr(0, commaPos);
-            int duration = stoi(line.substr(commaPos + 1));
-            if (count < 10) {
-                tasks[count] = new Task(name, duration);
-                count++;
+            int duration;
+            try {
+                duration = stoi(line.substr(commaPos + 1));
+            } catch (...) {
+                continue; // Not a task line
+            }
+            if (!name.empty() && !byName.count(name)) {
+                byName.emplace(name, (int)tasks.size());
+                tasks.emplace_back(name, duration);
             }
         }
     }
@@ -78,7 +76,12 @@ void TaskManager::loadFromFile(string filename) {
 
 // Get pointer to task
 Task* TaskManager::getTaskAt(int index) {
-    if (index >= 0 && index < count)
-        return tasks[index];
+    if (index >= 0 && index < (int)tasks.size())
+        return &tasks[index];
     return nullptr;
 }
+
+// Number of tasks
+int TaskManager::size() {
+    return (int)tasks.size();
+}
@@ -1,19 +1,21 @@
 #pragma once
 
+#include <unordered_map>
+#include <vector>
 #include "task.h"
 
 class TaskManager {
 private:
-    Task* tasks[10];   // Array of pointers to Tasks
-    int count;         // Number of tasks
+    vector<Task> tasks;                  // Tasks in the order they were added
+    unordered_map<string, int> byName;   // Task name -> index in tasks
 
 public:
     TaskManager();                       // Constructor
-    ~TaskManager();                      // Destructor
-    void addTask(string name);           // Add new task
+    bool addTask(string name);           // Add new task; false if the name is empty or taken
     void showAllTasks();                 // Display all tasks
-    int binarySearch(string target);     // Search by name
-    void saveToFile(string filename);    // Save all tasks
+    int findTask(const string& target);  // Index of the task with this name, or -1
+    bool saveToFile(string filename);    // Save all tasks; false if the file cannot be written
     void loadFromFile(string filename);  // Load tasks
-    Task* getTaskAt(int index);          // Get pointer to task
+    Task* getTaskAt(int index);          // Get pointer to task (until the next addTask)
+    int size();                          // Number of tasks
 };
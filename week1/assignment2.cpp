@@ -1,17 +1,32 @@
-#include <iostream> 
-using namespace std; 
-int main() { 
-	string itemName; 
-	int quantity; 
-	float cost; 
- 
-	cout << "Enter item name: "; 
-	cin >> itemName; 
-	cout << "Enter quantity: "; 
-	cin >> quantity; 
-	cout << "Enter cost: "; 
-	cin >> cost; 
- 
-	cout << "Total cost for " << itemName << ": $" << (quantity * cost) << endl; 
-	return 0; 
-} 
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "../common/money.h"
+#include "../common/pricing.h"
+using namespace std;
+
+// Build: g++ -std=c++17 assignment2.cpp ../common/money.cpp ../common/pricing.cpp
+
+int main() {
+	string itemName;
+	int quantity;
+	string costText;
+	Cents cost;
+
+	cout << "Enter item name: ";
+	cin >> itemName;
+	cout << "Enter quantity: ";
+	cin >> quantity;
+	cout << "Enter cost: ";
+	cin >> costText;
+
+	// Cents, not float: 3 x 0.10 is exactly 0.30
+	bool valid = cin && parseCents(costText, cost) && cost >= 0 && cost <= INT32_MAX;
+	if (!valid || !lineValid(quantity, (int32_t)cost, 0, 0)) {
+		cout << "Invalid quantity or cost" << endl;
+		return 1;
+	}
+
+	cout << "Total cost for " << itemName << ": $" << formatCents(linePrice(quantity, (int32_t)cost, 0, 0)) << endl;
+	return 0;
+}
@@ -1,28 +1,19 @@
 #include <iostream>
 #include <string>
+#include "../common/inventoryindex.h"
 using namespace std;
 
+// Build: g++ -std=c++17 assignment5.cpp ../common/inventoryindex.cpp
+
 struct Item {
     string name;
     int id;
 };
 
-string binarySearch(Item* items, int targetId, int low, int high) {
-    if (low > high) {
-        return "Not found"; // Not found
-    }
-
-    int mid = (low + high) / 2;
-
-    if (items[mid].id == targetId) {
-        return items[mid].name;
-    } else if (items[mid].id < targetId) {
-        // Search right half
-        return binarySearch(items, targetId, mid + 1, high);
-    } else {
-        // Search left half
-        return binarySearch(items, targetId, low, mid - 1);
-    }
+// Returns the item with this ID, or nullptr; no copy of its name is made
+const Item* findItem(const Item* items, const IdIndex& index, int targetId) {
+    int64_t row = index.find(targetId);
+    return row >= 0 ? &items[row] : nullptr;
 }
 
 
@@ -36,13 +27,20 @@ int main() {
     inventory[3] = {"Bow", 4};
     inventory[4] = {"Arrow", 5};
 
+    int ids[5];
+    for (int i = 0; i < 5; i++) {
+        ids[i] = inventory[i].id;
+    }
+    IdIndex index;
+    index.build(ids, 5);
+
     int targetId;
     cout << "Enter item ID to search: ";
     cin >> targetId;
 
-    string result = binarySearch(inventory, targetId, 0, 4);
+    const Item* result = findItem(inventory, index, targetId);
 
-    cout << result << endl;
+    cout << (result ? result->name : "Not found") << endl;
 
     delete[] inventory;
 }
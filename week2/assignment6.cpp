@@ -1,45 +1,50 @@
 #include <iostream> 
-#include <fstream> 
 #include <string> 
+#include "../common/mappedinventory.h"
 using namespace std; 
+
+// Build: g++ -std=c++17 assignment6.cpp ../common/mappedinventory.cpp ../common/mappedfile.cpp
  
 class Item { 
 public: 
     string name; 
     int quantity; 
+    int64_t id = -1; // Slot in the inventory file once saved
 
-    void saveToFile() { 
-        ofstream out("items.txt"); 
-        if (out.is_open()) { 
-            out << name << "," << quantity << endl; 
-            out.close(); 
+    // Adds the item to the file, or updates its quantity in place if it is already there
+    void saveToFile(MappedInventory& inventory) { 
+        if (id < 0) id = inventory.find(name);
+        bool saved = id >= 0 ? inventory.setQuantity((uint32_t)id, quantity)
+                             : (id = inventory.add(name, quantity)) >= 0;
+        if (saved) {
             cout << "Item saved to file." << endl; 
         } else { 
             cout << "Unable to open file for writing." << endl; 
         } 
     }
 
-    void loadFromFile() { 
-        ifstream in("items.txt"); 
-        if (in.is_open()) { 
-            string line; 
-            while (getline(in, line)) { 
-                cout << "File content: " << line << endl; 
-            } 
-            in.close(); 
-        } else { 
-            cout << "Unable to open file for reading." << endl; 
-        } 
+    void loadFromFile(const MappedInventory& inventory) { 
+        for (uint32_t i = 0; i < inventory.capacity(); i++) {
+            if (inventory.contains(i)) {
+                cout << "File content: " << inventory.name(i) << "," << inventory.quantity(i) << endl; 
+            }
+        }
     } 
 }; 
  
 int main() { 
+    MappedInventory inventory;
+    if (!inventory.open("items.inv")) {
+        cout << "Unable to open file for reading." << endl; 
+        return 1;
+    }
+
     Item tool; 
     tool.name = "Hammer"; 
     tool.quantity = 5; 
  
-    tool.saveToFile(); 
-    tool.loadFromFile(); // optional 
+    tool.saveToFile(inventory); 
+    tool.loadFromFile(inventory); // optional 
  
     return 0; 
 }
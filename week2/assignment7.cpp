@@ -1,8 +1,11 @@
 #include <iostream>
 #include <string>
+#include "../common/itemstore.h"
 using namespace std;
 
-// Base class
+// Build: g++ -std=c++17 assignment7.cpp
+
+// Base class (shared fields; each kind is stored as itself, so nothing is virtual)
 class Item {
 public:
     string name;
@@ -12,8 +15,6 @@ public:
         name = n;
         quantity = q;
     }
-
-    virtual void display() = 0; // Pure virtual function
 };
 
 // Perishable item
@@ -21,7 +22,7 @@ class Perishable : public Item {
 public:
     Perishable(string n, int q) : Item(n, q) {}
 
-    void display() override {
+    void display() const {
         cout << name << " (Perishable), Qty: " << quantity << endl;
     }
 };
@@ -31,22 +32,21 @@ class NonPerishable : public Item {
 public:
     NonPerishable(string n, int q) : Item(n, q) {}
 
-    void display() override {
+    void display() const {
         cout << name << " (Non-Perishable), Qty: " << quantity << endl;
     }
 };
 
-int main() {
-    // Create inventory using base class pointers
-    Item* item1 = new Perishable("Milk", 10);
-    Item* item2 = new NonPerishable("Cereal", 20);
+using Inventory = ItemStore<Perishable, NonPerishable>;
 
-    item1->display();
-    item2->display();
+int main() {
+    // Each kind is kept in its own array; no item is allocated on its own
+    Inventory inventory;
+    inventory.add(Perishable("Milk", 10));
+    inventory.add(NonPerishable("Cereal", 20));
 
-    // Clean up
-    delete item1;
-    delete item2;
+    // The callback is compiled once per kind, so display() is called directly
+    inventory.forEach([](const auto& item) { item.display(); });
 
     return 0;
 }
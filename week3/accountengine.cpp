@@ -0,0 +1,119 @@
+#include "accountengine.h"
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define ACCOUNT_PAUSE() _mm_pause()
+#else
+#define ACCOUNT_PAUSE() ((void)0)
+#endif
+
+/*
+This source file implements the lock-free balance updates and the
+ordered-locking transfers of AccountEngine declared in accountengine.h.
+*/
+
+// ---------------------------------------------------------------- Slots
+
+AccountEngine::AccountEngine(size_t accounts) : slots(new AccountSlot[accounts]), count(accounts) {
+}
+
+size_t AccountEngine::size() const {
+    return count;
+}
+
+// Transfers hold a lock for a few instructions, so spin briefly before giving up the core
+void AccountEngine::lockSlot(AccountSlot& slot) {
+    for (int spins = 0; slot.lock.exchange(1, std::memory_order_acquire) != 0;) {
+        while (slot.lock.load(std::memory_order_relaxed) != 0) {
+            if (++spins < 64) ACCOUNT_PAUSE();
+            else std::this_thread::yield(); // The holder may be waiting for this core
+        }
+    }
+}
+
+void AccountEngine::unlockSlot(AccountSlot& slot) {
+    slot.lock.store(0, std::memory_order_release);
+}
+
+// ---------------------------------------------------------------- Balance updates
+
+bool AccountEngine::debit(AccountSlot& slot, Cents amount) {
+    Cents current = slot.balance.load(std::memory_order_relaxed);
+    do {
+        if (current < amount) return false; // Checked against the value the swap replaces
+    } while (!slot.balance.compare_exchange_weak(current, current - amount, std::memory_order_acq_rel,
+                                                 std::memory_order_relaxed));
+    return true;
+}
+
+bool AccountEngine::credit(AccountSlot& slot, Cents amount) {
+    Cents current = slot.balance.load(std::memory_order_relaxed);
+    do {
+        if (current > INT64_MAX - amount) return false;
+    } while (!slot.balance.compare_exchange_weak(current, current + amount, std::memory_order_acq_rel,
+                                                 std::memory_order_relaxed));
+    return true;
+}
+
+bool AccountEngine::deposit(uint64_t account, Cents amount) {
+    if (account >= count || amount < 0) return false;
+    return credit(slots[account], amount);
+}
+
+bool AccountEngine::withdraw(uint64_t account, Cents amount) {
+    if (account >= count || amount < 0) return false;
+    return debit(slots[account], amount);
+}
+
+bool AccountEngine::transfer(uint64_t from, uint64_t to, Cents amount) {
+    if (from >= count || to >= count || from == to || amount < 0) return false;
+    AccountSlot& source = slots[from];
+    AccountSlot& target = slots[to];
+    AccountSlot& first = from < to ? source : target; // Always the lower index first
+    AccountSlot& second = from < to ? target : source;
+    lockSlot(first);
+    lockSlot(second);
+
+    bool done = debit(source, amount);
+    if (done && !credit(target, amount)) {
+        source.balance.fetch_add(amount, std::memory_order_acq_rel); // Would overflow the target; undo
+        done = false;
+    }
+
+    unlockSlot(second);
+    unlockSlot(first);
+    return done;
+}
+
+bool AccountEngine::restore(uint64_t account, Cents balance) {
+    if (account >= count) return false;
+    slots[account].balance.store(balance, std::memory_order_relaxed);
+    return true;
+}
+
+// ---------------------------------------------------------------- Reading
+
+Cents AccountEngine::balance(uint64_t account) const {
+    return account < count ? slots[account].balance.load(std::memory_order_acquire) : 0;
+}
+
+void AccountEngine::balancePair(uint64_t a, uint64_t b, Cents& balanceA, Cents& balanceB) {
+    balanceA = balance(a);
+    balanceB = balance(b);
+    if (a >= count || b >= count || a == b) return;
+    AccountSlot& first = a < b ? slots[a] : slots[b];
+    AccountSlot& second = a < b ? slots[b] : slots[a];
+    lockSlot(first);
+    lockSlot(second);
+    balanceA = slots[a].balance.load(std::memory_order_acquire);
+    balanceB = slots[b].balance.load(std::memory_order_acquire);
+    unlockSlot(second);
+    unlockSlot(first);
+}
+
+Cents AccountEngine::total() const {
+    Cents sum = 0;
+    for (size_t i = 0; i < count; i++) sum += slots[i].balance.load(std::memory_order_relaxed);
+    return sum;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "ledger.h"
+
+/*
+This header file defines AccountEngine, the balances of many accounts
+(millions) shared by any number of threads.
+
+Each account has its own 64-byte slot, so threads working on different
+accounts never share a cache line. Deposits and withdrawals are
+lock-free: a compare-and-swap loop on the 64-bit balance, and a
+withdrawal that would overdraw the account fails without changing it.
+
+A transfer locks its two accounts in index order (so two transfers
+between the same pair can never deadlock), then debits and credits with
+the same atomic operations. Holding both locks makes the pair of changes
+atomic with respect to other transfers and to balancePair(). Plain
+deposits and withdrawals never wait for the locks; they cannot lose an
+update either way, because every change is a single atomic operation.
+
+Money is only created by deposit() and destroyed by withdraw(): when no
+operation is running, total() equals the deposits minus the withdrawals
+ever made, whatever the interleaving.
+*/
+
+// One account, alone on its cache line
+struct alignas(64) AccountSlot {
+    std::atomic<Cents> balance{0};
+    std::atomic<uint32_t> lock{0}; // Held by a transfer touching this account
+};
+
+class AccountEngine {
+private:
+    std::unique_ptr<AccountSlot[]> slots;
+    size_t count = 0;
+
+    void lockSlot(AccountSlot& slot);
+    void unlockSlot(AccountSlot& slot);
+    static bool debit(AccountSlot& slot, Cents amount);  // CAS loop; false if it would overdraw
+    static bool credit(AccountSlot& slot, Cents amount); // CAS loop; false if it would overflow
+
+public:
+    explicit AccountEngine(size_t accounts);
+
+    size_t size() const;
+
+    // Each returns false, changing nothing, for an unknown account, a negative amount, an
+    // overdraft or a balance that would overflow
+    bool deposit(uint64_t account, Cents amount);
+    bool withdraw(uint64_t account, Cents amount);
+    bool transfer(uint64_t from, uint64_t to, Cents amount); // Also false if from == to
+
+    // Sets a balance outright, bypassing every check; for recovery, while nothing else runs.
+    // False for an unknown account.
+    bool restore(uint64_t account, Cents balance);
+
+    Cents balance(uint64_t account) const;             // 0 for an unknown account
+    void balancePair(uint64_t a, uint64_t b, Cents& balanceA, Cents& balanceB); // Never mid-transfer
+    Cents total() const;                               // Exact only while no operation is running
+};
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+#include "accountengine.h"
+
+// Build: g++ -std=c++17 -O2 -pthread accountengine_test.cpp accountengine.cpp
+//
+// Proves AccountEngine conserves money under concurrency: threads deposit, withdraw and transfer at
+// random over a few hot accounts and many cold ones, and afterwards total() must equal the successful
+// deposits minus the successful withdrawals, with no balance below zero. A reader checks that
+// balancePair() never sees a transfer half done, and opposite transfers between the same pair run
+// at once (a lock-order deadlock would hang here). Exits 1 on any failure.
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        std::printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+// Random operations from several threads; returns the money that should be in the engine
+static Cents hammer(AccountEngine& engine, int threads, int operations) {
+    std::vector<Cents> net((size_t)threads, 0); // Successful deposits minus withdrawals, per thread
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            std::mt19937_64 random((uint64_t)t + 1);
+            auto account = [&]() { // Half the operations hit one of 8 hot accounts
+                return random() % 2 ? random() % 8 : random() % engine.size();
+            };
+            for (int i = 0; i < operations; i++) {
+                Cents amount = (Cents)(random() % 10000);
+                switch (random() % 3) {
+                case 0:
+                    if (engine.deposit(account(), amount)) net[(size_t)t] += amount;
+                    break;
+                case 1:
+                    if (engine.withdraw(account(), amount)) net[(size_t)t] -= amount;
+                    break;
+                default:
+                    engine.transfer(account(), account(), amount); // Moves money, never makes any
+                    break;
+                }
+            }
+        });
+    }
+    for (std::thread& w : workers) w.join();
+    Cents expected = 0;
+    for (Cents n : net) expected += n;
+    return expected;
+}
+
+int main() {
+    // Argument checks
+    AccountEngine small(4);
+    check(!small.deposit(4, 1) && !small.deposit(0, -1), "deposit rejects an unknown account and a negative amount");
+    check(small.deposit(0, 500) && !small.withdraw(0, 501) && small.balance(0) == 500, "no overdraft");
+    check(!small.transfer(0, 0, 1) && !small.transfer(0, 1, 501) && small.balance(0) == 500, "bad transfers");
+    check(small.deposit(1, INT64_MAX - 100) && !small.deposit(1, 101), "deposit refuses to overflow");
+    check(!small.transfer(0, 1, 200) && small.balance(0) == 500 && small.balance(1) == INT64_MAX - 100,
+          "a transfer that would overflow changes neither account");
+
+    // Conservation under contention
+    int threads = (int)std::max(4u, std::thread::hardware_concurrency());
+    AccountEngine engine(1000);
+    Cents expected = hammer(engine, threads, 200000);
+    check(engine.total() == expected, "total equals deposits minus withdrawals");
+    bool nonNegative = true;
+    for (size_t a = 0; a < engine.size(); a++) nonNegative = nonNegative && engine.balance(a) >= 0;
+    check(nonNegative, "no balance below zero");
+
+    // Transfers are atomic to balancePair, and opposite transfers do not deadlock
+    AccountEngine pair(2);
+    pair.deposit(0, 1000000);
+    pair.deposit(1, 1000000);
+    std::atomic<bool> done{false};
+    std::atomic<long> torn{0};
+    std::thread reader([&]() {
+        while (!done.load()) {
+            Cents a, b;
+            pair.balancePair(0, 1, a, b);
+            if (a + b != 2000000) torn++;
+        }
+    });
+    std::vector<std::thread> movers;
+    for (int t = 0; t < 4; t++) {
+        movers.emplace_back([&, t]() {
+            for (int i = 0; i < 200000; i++) pair.transfer((uint64_t)(t % 2), (uint64_t)(1 - t % 2), 1 + i % 50);
+        });
+    }
+    for (std::thread& m : movers) m.join();
+    done = true;
+    reader.join();
+    check(torn.load() == 0, "balancePair never sees half a transfer");
+    check(pair.total() == 2000000, "transfers between a pair keep its total");
+
+    std::printf(failures ? "%d checks failed\n" : "All checks passed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -1,54 +1,82 @@
 #include <iostream>
-#include <fstream>
 #include <string>
+#include "accountengine.h"
+#include "ledger.h"
+#include "recovery.h"
 using namespace std;
 
+// Build: g++ -std=c++17 -pthread assignment8.cpp accountengine.cpp ledger.cpp recovery.cpp ../common/mappedfile.cpp ../common/money.cpp
+
+const uint64_t SnapshotInterval = 100000; // Snapshot the balances once this many records follow the last one
+
 class BankAccount {
 private:
-    double balance;
+    Ledger& ledger;          // Every transaction is committed here before it counts
+    AccountEngine& accounts; // Holds the balance, in cents, shared safely between threads
+    uint64_t account;        // Account number in the ledger and the engine
 
 public:
-    BankAccount() {
-        balance = 0.0;
+    BankAccount(Ledger& ledger, AccountEngine& accounts, uint64_t account)
+        : ledger(ledger), accounts(accounts), account(account) {
     }
 
-    void deposit(double amount) {
-        balance += amount;
-        saveTransaction("Deposit", amount);
+    void deposit(Cents amount) {
+        if (saveTransaction(LedgerKind::Deposit, amount, "Deposit")) {
+            accounts.deposit(account, amount);
+        }
     }
 
-    void makePurchase(string item, double cost) {
-        if (cost > balance) {
+    // The funds are checked and taken in one step, so two purchases at once cannot both pass
+    // the check; they are given back if the purchase cannot be recorded
+    void makePurchase(string item, Cents cost) {
+        if (!accounts.withdraw(account, cost)) {
             cout << "Insufficient funds for " << item << endl;
-        } else {
-            balance -= cost;
-            saveTransaction("Purchase - " + item, cost);
+        } else if (!saveTransaction(LedgerKind::Purchase, -cost, "Purchase - " + item)) {
+            accounts.deposit(account, cost);
         }
     }
 
 
 void displayBalance() {
-        cout << "Current Balance: $" << balance << endl;
+        cout << "Current Balance: $" << formatCents(accounts.balance(account)) << endl;
     }
 
-    void saveTransaction(string type, double amount) {
-        ofstream file("transactions.txt", ios::app);
-        if (file.is_open()) {
-            file << type << ": $" << amount << endl;
-            file.close();
+    // Waits until the transaction is durable in the ledger (shared with any concurrent ones)
+    bool saveTransaction(LedgerKind kind, Cents amount, string description) {
+        if (!ledger.commit(account, kind, amount, description)) {
+            cout << "Could not record " << description << endl;
+            return false;
         }
+        return true;
     }
 };
 
 int main() {
-    BankAccount myAccount;
+    // Balances from earlier runs are rebuilt from the ledger before anything new is recorded
+    AccountEngine accounts(2); // Account numbers 0 and 1
+    RecoveryStats recovery;
+    if (recoverBalances("transactions.ledger", accounts, recovery) && recovery.lastSequence > 0) {
+        cout << "Recovered " << recovery.lastSequence << " transactions";
+        if (recovery.snapshotSequence > 0) {
+            cout << " (snapshot of the first " << recovery.snapshotSequence << ", " << recovery.replayed << " replayed)";
+        }
+        cout << endl;
+        if (recovery.replayed >= SnapshotInterval) {
+            writeBalanceSnapshot("transactions.ledger", accounts, recovery.lastSequence, recovery.lastChecksum);
+        }
+    }
+
+    Ledger ledger;
+    if (!ledger.open("transactions.ledger")) {
+        cout << "Cannot open transactions.ledger" << endl;
+        return 1;
+    }
+    BankAccount myAccount(ledger, accounts, 1);
 
-    myAccount.deposit(120.00);
-    myAccount.makePurchase("Notebook", 10.50);
-    myAccount.makePurchase("Pencil", 5.00);
+    myAccount.deposit(12000);           // $120.00
+    myAccount.makePurchase("Notebook", 1050);
+    myAccount.makePurchase("Pencil", 500);
     myAccount.displayBalance();
 
     return 0;
 }
-
-
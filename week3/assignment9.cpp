@@ -1,7 +1,10 @@
 #include <iostream>
 #include <string>
+#include "../common/inventoryindex.h"
 using namespace std;
 
+// Build: g++ -std=c++17 assignment9.cpp ../common/inventoryindex.cpp
+
 class Item {
 public:
     string name;
@@ -12,16 +15,12 @@ public:
     }
 };
 
-void searchItem(Item inventory[], int size, string searchName) {
-    bool found = false;
-    for (int i = 0; i < size; i++) {
-        if (inventory[i].name == searchName) {
-            cout << "Found: " << inventory[i].name << " - Quantity: " << inventory[i].quantity << endl;
-            found = true;
-            break;
-        }
-    }
-    if (!found) {
+// Looks the name up in the index instead of comparing it with every item
+void searchItem(Item inventory[], const NameIndex& index, const string& searchName) {
+    int64_t row = index.find(searchName);
+    if (row >= 0) {
+        cout << "Found: " << inventory[row].name << " - Quantity: " << inventory[row].quantity << endl;
+    } else {
         cout << "Item not found in inventory." << endl;
     }
 }
@@ -44,11 +43,18 @@ int main() {
         inventory[i].display();
     }
 
+    // Index the names; with a repeated name the first item wins, as with a scan
+    NameIndex index;
+    index.reserve(SIZE);
+    for (int i = 0; i < SIZE; i++) {
+        index.insert(inventory[i].name, i);
+    }
+
     // Search for an item
     string searchName;
     cout << "\nEnter item name to search: ";
     cin >> searchName;
-    searchItem(inventory, SIZE, searchName);
+    searchItem(inventory, index, searchName);
 
     return 0;
 }
@@ -0,0 +1,283 @@
+#include "ledger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+This source file implements the record checksum and the group-committing
+Ledger declared in ledger.h.
+*/
+
+// ---------------------------------------------------------------- Records
+
+// FNV-1a over every byte before the checksum field
+static uint32_t recordChecksum(const LedgerRecord& record) {
+    const unsigned char* p = (const unsigned char*)&record;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < offsetof(LedgerRecord, checksum); i++) h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+bool ledgerRecordValid(const LedgerRecord& record) {
+    return record.kind != 0 && record.descriptionLength <= LedgerDescriptionBytes &&
+           record.checksum == recordChecksum(record);
+}
+
+std::string LedgerRecord::text() const {
+    return std::string(description, std::min<size_t>(descriptionLength, LedgerDescriptionBytes));
+}
+
+// ---------------------------------------------------------------- File access
+
+static int openFile(const std::string& path, bool write) {
+#ifdef _WIN32
+    return write ? _open(path.c_str(), _O_RDWR | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE)
+                 : _open(path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+    return write ? ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644)
+                 : ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+}
+
+static void closeFile(int fd) {
+#ifdef _WIN32
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+static int64_t fileSize(int fd) {
+#ifdef _WIN32
+    return _lseeki64(fd, 0, SEEK_END);
+#else
+    struct stat info;
+    return fstat(fd, &info) == 0 ? (int64_t)info.st_size : -1;
+#endif
+}
+
+// Reads count records starting at record index first; returns how many were read
+static size_t readRecords(int fd, uint64_t first, LedgerRecord* out, size_t count) {
+    char* p = (char*)out;
+    size_t want = count * sizeof(LedgerRecord), got = 0;
+#ifdef _WIN32
+    if (_lseeki64(fd, (int64_t)(first * sizeof(LedgerRecord)), SEEK_SET) < 0) return 0;
+    while (got < want) {
+        int n = _read(fd, p + got, (unsigned)std::min(want - got, (size_t)1 << 30));
+        if (n <= 0) break;
+        got += (size_t)n;
+    }
+#else
+    while (got < want) {
+        ssize_t n = ::pread(fd, p + got, want - got, (off_t)(first * sizeof(LedgerRecord) + got));
+        if (n <= 0) break;
+        got += (size_t)n;
+    }
+#endif
+    return got / sizeof(LedgerRecord);
+}
+
+static bool writeAt(int fd, uint64_t offset, const char* data, size_t length) {
+#ifdef _WIN32
+    if (_lseeki64(fd, (int64_t)offset, SEEK_SET) < 0) return false;
+    while (length > 0) {
+        int n = _write(fd, data, (unsigned)std::min(length, (size_t)1 << 30));
+        if (n <= 0) return false;
+        data += n;
+        length -= (size_t)n;
+    }
+#else
+    while (length > 0) {
+        ssize_t n = ::pwrite(fd, data, length, (off_t)offset);
+        if (n <= 0) return false;
+        data += n;
+        offset += (uint64_t)n;
+        length -= (size_t)n;
+    }
+#endif
+    return true;
+}
+
+static bool syncFile(int fd) {
+#ifdef _WIN32
+    return _commit(fd) == 0;
+#elif defined(__linux__)
+    return fdatasync(fd) == 0; // The size changes too, which fdatasync still covers
+#else
+    return fsync(fd) == 0;
+#endif
+}
+
+static bool truncateFile(int fd, uint64_t size) {
+#ifdef _WIN32
+    return _chsize_s(fd, (int64_t)size) == 0;
+#else
+    return ftruncate(fd, (off_t)size) == 0;
+#endif
+}
+
+bool readLedger(const std::string& path, std::vector<LedgerRecord>& records) {
+    records.clear();
+    int fd = openFile(path, false);
+    if (fd < 0) return false;
+    int64_t size = fileSize(fd);
+    records.resize(size > 0 ? (size_t)size / sizeof(LedgerRecord) : 0);
+    records.resize(readRecords(fd, 0, records.data(), records.size()));
+    closeFile(fd);
+
+    // Keep the unbroken run of valid, consecutive records from the start
+    size_t valid = 0;
+    while (valid < records.size() && ledgerRecordValid(records[valid]) &&
+           (valid == 0 || records[valid].sequence == records[valid - 1].sequence + 1)) {
+        valid++;
+    }
+    records.resize(valid);
+    return true;
+}
+
+// ---------------------------------------------------------------- Ledger
+
+Ledger::~Ledger() {
+    close();
+}
+
+bool Ledger::open(const std::string& path, const LedgerOptions& ledgerOptions) {
+    close();
+    fd = openFile(path, true);
+    if (fd < 0) return false;
+    options = ledgerOptions;
+    options.maxBatch = std::max<size_t>(options.maxBatch, 1);
+
+    // Only the last batch can be torn (each one is synced before the next is written), so
+    // check the tail: from one batch before the end, keep valid consecutive records
+    int64_t size = fileSize(fd);
+    uint64_t count = size > 0 ? (uint64_t)size / sizeof(LedgerRecord) : 0;
+    uint64_t first = count > options.maxBatch + 1 ? count - options.maxBatch - 1 : 0;
+    std::vector<LedgerRecord> tail((size_t)(count - first));
+    tail.resize(readRecords(fd, first, tail.data(), tail.size()));
+    size_t valid = 0;
+    while (valid < tail.size() && ledgerRecordValid(tail[valid]) &&
+           (valid == 0 || tail[valid].sequence == tail[valid - 1].sequence + 1)) {
+        valid++;
+    }
+    uint64_t end = (first + valid) * sizeof(LedgerRecord);
+    if ((uint64_t)size != end && !truncateFile(fd, end)) {
+        closeFile(fd);
+        fd = -1;
+        return false;
+    }
+
+    fileEnd = end;
+    durableSequence = valid > 0 ? tail[valid - 1].sequence : 0;
+    nextSequence = durableSequence + 1;
+    pending.clear();
+    closing = false;
+    failed = false;
+    batches = 0;
+    writer = std::thread(&Ledger::writerLoop, this);
+    return true;
+}
+
+void Ledger::close() {
+    if (fd < 0) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    queued.notify_one();
+    writer.join();
+    closeFile(fd);
+    fd = -1;
+}
+
+uint64_t Ledger::append(uint64_t account, LedgerKind kind, Cents amount, const std::string& description) {
+    LedgerRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.timeMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::system_clock::now().time_since_epoch()).count();
+    record.account = account;
+    record.amount = amount;
+    record.kind = (uint8_t)kind;
+    record.descriptionLength = (uint8_t)std::min(description.size(), LedgerDescriptionBytes);
+    std::memcpy(record.description, description.data(), record.descriptionLength);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    record.sequence = nextSequence++; // Numbered under the lock so the file stays in order
+    record.checksum = recordChecksum(record);
+    lastQueued = std::chrono::steady_clock::now();
+    if (pending.empty()) firstQueued = lastQueued;
+    pending.push_back(record);
+    // The writer only needs waking for the first record of a batch, or when one fills up
+    if (pending.size() == 1 || pending.size() == options.maxBatch) queued.notify_one();
+    return record.sequence;
+}
+
+bool Ledger::waitDurable(uint64_t sequence) {
+    std::unique_lock<std::mutex> lock(mutex);
+    durable.wait(lock, [&]() { return durableSequence >= sequence || failed; });
+    return durableSequence >= sequence;
+}
+
+bool Ledger::commit(uint64_t account, LedgerKind kind, Cents amount, const std::string& description) {
+    return waitDurable(append(account, kind, amount, description));
+}
+
+uint64_t Ledger::lastSequence() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return nextSequence - 1;
+}
+
+size_t Ledger::batchCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return batches;
+}
+
+void Ledger::writerLoop() {
+    std::vector<LedgerRecord> batch;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        queued.wait(lock, [&]() { return !pending.empty() || closing; });
+        if (pending.empty()) break; // Closing with nothing left to write
+
+        // Give concurrent transactions until the oldest one has waited commitInterval to join, but
+        // stop early once nothing has arrived for an eighth of it (every committer is already waiting)
+        if (!closing && options.commitIntervalMicros > 0) {
+            auto interval = std::chrono::microseconds(options.commitIntervalMicros);
+            auto deadline = firstQueued + interval;
+            while (!closing && pending.size() < options.maxBatch) {
+                auto quiet = lastQueued + interval / 8;
+                if (std::chrono::steady_clock::now() >= std::min(deadline, quiet)) break;
+                queued.wait_until(lock, std::min(deadline, quiet));
+            }
+        }
+        // Never more than maxBatch: open() only checks that many records at the end for a torn write
+        size_t take = std::min(pending.size(), options.maxBatch);
+        batch.assign(pending.begin(), pending.begin() + (std::ptrdiff_t)take);
+        pending.erase(pending.begin(), pending.begin() + (std::ptrdiff_t)take);
+        uint64_t offset = fileEnd;
+        fileEnd += batch.size() * sizeof(LedgerRecord);
+        bool ok = !failed; // Nothing more is written after a failure, so the file has no gaps
+        lock.unlock();
+
+        // One write and one sync for the whole batch; appends keep queueing meanwhile
+        ok = ok && writeAt(fd, offset, (const char*)batch.data(), batch.size() * sizeof(LedgerRecord)) &&
+                  (!options.sync || syncFile(fd));
+
+        lock.lock();
+        if (ok) durableSequence = batch.back().sequence;
+        else failed = true;
+        batches++;
+        batch.clear();
+        durable.notify_all();
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../common/money.h"
+
+/*
+This header file defines the transaction ledger: an append-only binary
+file of fixed 64-byte records with amounts in cents (int64), so sums
+never drift the way doubles do.
+
+Appends are group-committed. append() only queues the record; a writer
+thread collects everything queued within commitInterval (or maxBatch
+records, whichever comes first, or sooner once new records stop
+arriving), writes the batch with one write() and makes it durable with
+one fsync. Concurrent transactions therefore share the cost of a sync
+instead of paying one each. Records queued beyond maxBatch wait for the
+next batch, so a crash can only tear the last maxBatch records. commit()
+is append plus waiting until the record is durable, so a caller never
+reports a transaction that a crash could still lose.
+
+Every record carries a checksum. Opening an existing ledger drops a torn
+record at the end (a crash in the middle of a write) and continues the
+sequence numbers after the last good one.
+*/
+
+enum class LedgerKind : uint8_t { Deposit = 1, Purchase = 2 };
+
+const size_t LedgerDescriptionBytes = 26;
+
+// One transaction as stored in the file (64 bytes, native byte order)
+struct LedgerRecord {
+    uint64_t sequence;      // 1, 2, 3, ... in file order
+    int64_t timeMicros;     // Microseconds since the Unix epoch when appended
+    uint64_t account;
+    Cents amount;           // Signed change to the balance (purchases are negative)
+    uint8_t kind;           // LedgerKind
+    uint8_t descriptionLength;
+    char description[LedgerDescriptionBytes]; // Truncated to fit; not NUL-terminated
+    uint32_t checksum;      // Over every byte before it
+
+    std::string text() const; // The description as a string
+};
+
+static_assert(sizeof(LedgerRecord) == 64, "Ledger records are one cache line");
+
+bool ledgerRecordValid(const LedgerRecord& record); // Checksum matches
+
+struct LedgerOptions {
+    int commitIntervalMicros = 1000; // Longest a queued record waits for its batch (0: write each at once)
+    size_t maxBatch = 4096;          // Most records in one batch; a full one is written without waiting
+    bool sync = true;                // fsync every batch; false leaves flushing to the OS
+};
+
+class Ledger {
+private:
+    int fd = -1;
+    LedgerOptions options;
+    std::mutex mutex;
+    std::condition_variable queued;  // Writer: records arrived or closing
+    std::condition_variable durable; // Waiters: a batch was committed
+    std::deque<LedgerRecord> pending;
+    std::chrono::steady_clock::time_point firstQueued; // When the oldest pending record was appended
+    std::chrono::steady_clock::time_point lastQueued;  // When the newest one was
+    uint64_t fileEnd = 0;            // Where the next batch goes
+    uint64_t nextSequence = 1;       // Sequence of the next appended record
+    uint64_t durableSequence = 0;    // Every record up to this one is on disk
+    bool closing = false;
+    bool failed = false;             // A write or sync failed; commit() returns false from then on
+    size_t batches = 0;
+    std::thread writer;
+
+    void writerLoop();
+
+public:
+    Ledger() = default;
+    ~Ledger();
+    Ledger(const Ledger&) = delete;
+    Ledger& operator=(const Ledger&) = delete;
+
+    // Opens or creates the ledger file and starts the writer thread. False if it cannot be opened.
+    bool open(const std::string& path, const LedgerOptions& options = LedgerOptions());
+    void close(); // Commits whatever is queued, then stops the writer
+
+    // Queues a record and returns its sequence number without waiting for the disk
+    uint64_t append(uint64_t account, LedgerKind kind, Cents amount, const std::string& description);
+
+    // Blocks until the record with this sequence number is durable; false if writing failed
+    bool waitDurable(uint64_t sequence);
+
+    // append() + waitDurable()
+    bool commit(uint64_t account, LedgerKind kind, Cents amount, const std::string& description);
+
+    uint64_t lastSequence();   // Sequence of the newest record appended (0 if none)
+    size_t batchCount();       // Batches written so far (each one write and one sync)
+};
+
+// Reads every valid record of a ledger file in order, stopping at the first torn or corrupt one.
+// False if the file cannot be opened.
+bool readLedger(const std::string& path, std::vector<LedgerRecord>& records);
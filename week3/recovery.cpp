@@ -0,0 +1,215 @@
+#include "recovery.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "../common/cpu.h"
+#include "../common/mappedfile.h"
+
+/*
+This source file implements the parallel ledger replay and the balance
+snapshots declared in recovery.h.
+*/
+
+const char SnapshotMagic[8] = {'B', 'A', 'L', 'S', 'N', 'A', 'P', 0};
+const uint32_t SnapshotVersion = 1;
+const uint32_t ByteOrderMark = 0x01020304; // Reads back differently on a machine of the other endianness
+const size_t ParallelRecords = 1 << 16;    // Smaller ledgers replay on one thread
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t sequence;        // Last ledger record included in the balances
+    uint32_t recordChecksum;  // That record's checksum
+    uint32_t reserved;
+    uint64_t accounts;        // Balances (Cents) that follow the header, account 0 first
+    uint64_t hash;            // Hash of those balances
+};
+
+// One record's effect, as sorted into its account's partition
+struct ReplayEntry {
+    uint64_t account;
+    Cents amount;
+};
+
+static uint64_t balanceHash(const Cents* balances, size_t count) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ count;
+    for (size_t i = 0; i < count; i++) {
+        h = (h ^ (uint64_t)balances[i]) * 0x100000001B3ull;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+// ---------------------------------------------------------------- Ledger
+
+// Index of the first record from begin on that is damaged or out of sequence (count if none); the
+// records before begin are already known to be good
+static size_t firstInvalid(const LedgerRecord* records, size_t begin, size_t count, int threads) {
+    if (count - begin < ParallelRecords) threads = 1;
+    std::vector<size_t> firstBad(threads, count);
+    runSlices(count - begin, threads, [&](int slice, size_t sliceBegin, size_t sliceEnd) {
+        for (size_t i = begin + sliceBegin; i < begin + sliceEnd; i++) {
+            if (!ledgerRecordValid(records[i]) || (i > 0 && records[i].sequence != records[i - 1].sequence + 1)) {
+                firstBad[slice] = i;
+                break;
+            }
+        }
+    });
+    return *std::min_element(firstBad.begin(), firstBad.end());
+}
+
+// Applies records in order. Partitioned by account, so each partition's thread owns its accounts.
+static void replay(const LedgerRecord* records, size_t count, AccountEngine& accounts, int threads,
+                   uint64_t& skipped) {
+    uint64_t size = accounts.size();
+    if (count < ParallelRecords || threads == 1) {
+        for (size_t i = 0; i < count; i++) {
+            uint64_t account = records[i].account;
+            if (account < size) accounts.restore(account, accounts.balance(account) + records[i].amount);
+            else skipped++;
+        }
+        return;
+    }
+
+    // Count each slice's records per partition, then give every (partition, slice) pair its own
+    // range; partition-major, slice-minor, so each partition keeps ledger order
+    size_t partitions = (size_t)threads;
+    std::vector<size_t> offsets(threads * partitions, 0);
+    std::vector<uint64_t> skippedBySlice(threads, 0);
+    runSlices(count, threads, [&](int slice, size_t begin, size_t end) {
+        size_t* counts = offsets.data() + slice * partitions;
+        for (size_t i = begin; i < end; i++) {
+            if (records[i].account < size) counts[records[i].account % partitions]++;
+            else skippedBySlice[slice]++;
+        }
+    });
+    std::vector<size_t> partitionStart(partitions + 1, 0);
+    size_t total = 0;
+    for (size_t p = 0; p < partitions; p++) {
+        partitionStart[p] = total;
+        for (int t = 0; t < threads; t++) {
+            size_t c = offsets[t * partitions + p];
+            offsets[t * partitions + p] = total;
+            total += c;
+        }
+    }
+    partitionStart[partitions] = total;
+    for (uint64_t s : skippedBySlice) skipped += s;
+
+    std::vector<ReplayEntry> entries(total);
+    runSlices(count, threads, [&](int slice, size_t begin, size_t end) {
+        size_t* next = offsets.data() + slice * partitions;
+        for (size_t i = begin; i < end; i++) {
+            uint64_t account = records[i].account;
+            if (account < size) entries[next[account % partitions]++] = {account, records[i].amount};
+        }
+    });
+
+    runSlices(partitions, threads, [&](int, size_t begin, size_t end) {
+        for (size_t p = begin; p < end; p++) {
+            for (size_t i = partitionStart[p]; i < partitionStart[p + 1]; i++) {
+                const ReplayEntry& entry = entries[i];
+                accounts.restore(entry.account, accounts.balance(entry.account) + entry.amount);
+            }
+        }
+    });
+}
+
+// ---------------------------------------------------------------- Snapshots
+
+std::string balanceSnapshotPath(const std::string& ledgerPath) {
+    return ledgerPath + ".snapshot";
+}
+
+// Loads the snapshot into accounts if the ledger's first count records (not yet validated) still
+// hold the record it was taken at; returns the number of records it covers (0 if it was not used)
+static uint64_t loadSnapshot(const std::string& path, const LedgerRecord* records, size_t count,
+                             AccountEngine& accounts) {
+    MappedFile file;
+    if (!file.open(path) || file.size() < sizeof(SnapshotHeader)) return 0;
+    SnapshotHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0 || header.version != SnapshotVersion ||
+        header.byteOrder != ByteOrderMark || header.accounts > accounts.size() ||
+        file.size() != sizeof(SnapshotHeader) + header.accounts * sizeof(Cents)) {
+        return 0;
+    }
+
+    // The ledger must still hold the record the snapshot was taken at
+    uint64_t sequence = header.sequence;
+    if (sequence == 0 || sequence > count || !ledgerRecordValid(records[sequence - 1]) ||
+        records[sequence - 1].sequence != sequence || records[sequence - 1].checksum != header.recordChecksum) {
+        return 0;
+    }
+
+    const Cents* balances = (const Cents*)(file.data() + sizeof(SnapshotHeader));
+    if (balanceHash(balances, (size_t)header.accounts) != header.hash) return 0;
+    for (uint64_t i = 0; i < header.accounts; i++) accounts.restore(i, balances[i]);
+    return sequence;
+}
+
+bool writeBalanceSnapshot(const std::string& ledgerPath, const AccountEngine& accounts, uint64_t sequence,
+                          uint32_t checksum) {
+    std::vector<Cents> balances(accounts.size());
+    for (size_t i = 0; i < balances.size(); i++) balances[i] = accounts.balance(i);
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SnapshotMagic, sizeof(SnapshotMagic));
+    header.version = SnapshotVersion;
+    header.byteOrder = ByteOrderMark;
+    header.sequence = sequence;
+    header.recordChecksum = checksum;
+    header.accounts = balances.size();
+    header.hash = balanceHash(balances.data(), balances.size());
+
+    std::string path = balanceSnapshotPath(ledgerPath), temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write((const char*)&header, sizeof(header));
+        out.write((const char*)balances.data(), (std::streamsize)(balances.size() * sizeof(Cents)));
+        if (!out.flush()) {
+            out.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------- Recovery
+
+bool recoverBalances(const std::string& ledgerPath, AccountEngine& accounts, RecoveryStats& stats, int threads) {
+    threads = hardwareThreads(threads);
+    stats = RecoveryStats();
+    for (size_t i = 0; i < accounts.size(); i++) accounts.restore(i, 0);
+
+    MappedFile ledger;
+    if (!ledger.open(ledgerPath)) return false;
+    const LedgerRecord* records = (const LedgerRecord*)ledger.data();
+    size_t count = ledger.size() / sizeof(LedgerRecord);
+
+    // Records up to the snapshot were validated when it was taken; only the tail is checked and
+    // replayed, so recovery time follows the tail rather than the whole ledger
+    stats.snapshotSequence = loadSnapshot(balanceSnapshotPath(ledgerPath), records, count, accounts);
+    size_t first = (size_t)stats.snapshotSequence; // Record n sits at index n - 1
+    count = firstInvalid(records, first, count, threads);
+    replay(records + first, count - first, accounts, threads, stats.skipped);
+    stats.replayed = count - first - stats.skipped;
+    if (count > 0) {
+        stats.lastSequence = records[count - 1].sequence;
+        stats.lastChecksum = records[count - 1].checksum;
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "accountengine.h"
+#include "ledger.h"
+
+/*
+This header file defines crash recovery of account balances from the
+ledger, and the balance snapshots that keep it short.
+
+Recovery maps the ledger, checks each record's checksum and sequence
+number (in parallel slices) and keeps the valid prefix, as readLedger()
+would. The records are then partitioned by account, each partition
+holding its accounts' records in ledger order, and every partition is
+replayed by its own thread. No two threads touch the same account, so
+replay needs no locks and applies each account's history in order.
+
+A snapshot holds every balance as of one ledger record, plus that
+record's checksum. When the record at that position in the ledger still
+matches, recovery loads the snapshot and checks and replays only the
+records after it; otherwise (a missing, damaged or unrelated snapshot)
+it replays the whole ledger. Snapshots are written to a temporary file and renamed
+over the old one, so a crash while writing leaves the previous snapshot.
+*/
+
+struct RecoveryStats {
+    uint64_t snapshotSequence = 0; // Last record covered by the snapshot used (0: none)
+    uint64_t replayed = 0;         // Ledger records applied on top of it
+    uint64_t skipped = 0;          // Records for accounts beyond the engine's size
+    uint64_t lastSequence = 0;     // Newest record recovered (0: empty ledger)
+    uint32_t lastChecksum = 0;     // Its checksum, which a snapshot at lastSequence is tied to
+};
+
+// Path of the snapshot file kept beside a ledger
+std::string balanceSnapshotPath(const std::string& ledgerPath);
+
+// Rebuilds every balance in accounts from the ledger and its snapshot (if usable). Must run
+// before any other operation on accounts. False if the ledger cannot be opened; every balance
+// is then zero.
+bool recoverBalances(const std::string& ledgerPath, AccountEngine& accounts, RecoveryStats& stats,
+                     int threads = 0);
+
+// Writes the balances as of the ledger record (sequence, checksum), e.g. stats.lastSequence and
+// stats.lastChecksum right after recovery. Nothing may change accounts meanwhile. False if the
+// file cannot be written.
+bool writeBalanceSnapshot(const std::string& ledgerPath, const AccountEngine& accounts, uint64_t sequence,
+                          uint32_t checksum);
@@ -1,5 +1,9 @@
 #include "employee.h"
 
+Employee::Employee() : User(EmployeeRole::mask) {}
+
+Employee::Employee(PermissionMask mask) : User(mask) {}
+
 void Employee::accessLevel() {
     cout << "Employee Access\n";
 }
@@ -3,5 +3,8 @@
 
 class Employee : public User {
 public:
+    Employee();
+    explicit Employee(PermissionMask mask);
+
     void accessLevel() override;
 };
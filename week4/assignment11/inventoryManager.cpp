@@ -1,5 +1,7 @@
 #include "inventoryManager.h"
 
+InventoryManager::InventoryManager() : Employee(InventoryManagerRole::mask) {}
+
 void InventoryManager::accessLevel() {
     cout << "Full Inventory Management Access\n";
 }
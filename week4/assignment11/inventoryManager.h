@@ -3,5 +3,7 @@
 
 class InventoryManager : public Employee {
 public:
+    InventoryManager();
+
     void accessLevel() override;
 };
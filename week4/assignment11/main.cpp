@@ -1,7 +1,25 @@
 #include "inventoryManager.h"
 
+// Build: g++ -std=c++17 main.cpp user.cpp employee.cpp inventoryManager.cpp permissions.cpp
+
+// Policy roles can be loaded at run time (e.g. from a file); they check just like compiled ones
+const string DefaultPolicy =
+    "clerk: view_inventory reserve_stock\n"
+    "teller < clerk: view_accounts deposit withdraw\n";
+
 int main() {
     InventoryManager mgr;
     mgr.accessLevel();
+    cout << "Can remove inventory: " << (mgr.can(Permission::RemoveInventory) ? "yes" : "no") << "\n";
+    cout << "Can transfer money: " << (mgr.can(Permission::Transfer) ? "yes" : "no") << "\n";
+
+    Policy policy;
+    string error;
+    if (!parsePolicy(DefaultPolicy, policy, error)) {
+        cout << "Bad policy: " << error << "\n";
+        return 1;
+    }
+    Employee teller(policyMask(policy, "teller"));
+    cout << "Teller can view inventory: " << (teller.can(Permission::ViewInventory) ? "yes" : "no") << "\n";
     return 0;
 }
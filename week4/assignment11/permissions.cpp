@@ -0,0 +1,149 @@
+#include "permissions.h"
+#include <sstream>
+#include <vector>
+
+/*
+This source file implements the permission names and the runtime policy
+parser declared in permissions.h.
+*/
+
+struct PermissionName {
+    Permission permission;
+    const char* name;
+};
+
+const PermissionName PermissionNames[] = {
+    {Permission::ViewInventory, "view_inventory"},
+    {Permission::EditInventory, "edit_inventory"},
+    {Permission::RemoveInventory, "remove_inventory"},
+    {Permission::ReserveStock, "reserve_stock"},
+    {Permission::ViewAccounts, "view_accounts"},
+    {Permission::Deposit, "deposit"},
+    {Permission::Withdraw, "withdraw"},
+    {Permission::Transfer, "transfer"},
+    {Permission::ViewReports, "view_reports"},
+    {Permission::ManageUsers, "manage_users"},
+};
+
+const char* permissionName(Permission permission) {
+    for (const PermissionName& entry : PermissionNames) {
+        if (entry.permission == permission) return entry.name;
+    }
+    return "unknown";
+}
+
+bool parsePermission(const std::string& name, Permission& permission) {
+    for (const PermissionName& entry : PermissionNames) {
+        if (name == entry.name) {
+            permission = entry.permission;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------- Policy
+
+namespace {
+
+// One role as written, before inheritance is resolved
+struct RoleLine {
+    std::string parent;    // Empty for a role without one
+    PermissionMask own = 0;
+    int line = 0;
+    int state = 0;         // 0 unresolved, 1 being resolved (a cycle if met again), 2 resolved
+};
+
+}
+
+static std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+// Resolves a role's mask (its own bits plus its ancestors'); false on a cycle or an unknown parent
+static bool resolve(const std::string& name, std::unordered_map<std::string, RoleLine>& roles, Policy& policy,
+                    std::string& error) {
+    RoleLine& role = roles[name];
+    if (role.state == 2) return true;
+    if (role.state == 1) {
+        error = "line " + std::to_string(role.line) + ": role '" + name + "' inherits from itself";
+        return false;
+    }
+    role.state = 1;
+    PermissionMask mask = role.own;
+    if (!role.parent.empty()) {
+        if (roles.find(role.parent) == roles.end()) {
+            error = "line " + std::to_string(role.line) + ": unknown parent role '" + role.parent + "'";
+            return false;
+        }
+        if (!resolve(role.parent, roles, policy, error)) return false;
+        mask |= policy[role.parent];
+    }
+    policy[name] = mask;
+    role.state = 2;
+    return true;
+}
+
+bool parsePolicy(const std::string& text, Policy& policy, std::string& error) {
+    policy.clear();
+    std::unordered_map<std::string, RoleLine> roles;
+    std::vector<std::string> order; // Roles in the order declared, for error messages in file order
+    std::istringstream in(text);
+    std::string raw;
+    int lineNumber = 0;
+    while (std::getline(in, raw)) {
+        lineNumber++;
+        std::string line = trim(raw.substr(0, raw.find('#')));
+        if (line.empty()) continue;
+
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            error = "line " + std::to_string(lineNumber) + ": expected 'role: permissions'";
+            return false;
+        }
+        std::string head = line.substr(0, colon);
+        size_t less = head.find('<');
+        RoleLine role;
+        role.line = lineNumber;
+        std::string name = trim(head.substr(0, less));
+        if (less != std::string::npos) role.parent = trim(head.substr(less + 1));
+        if (name.empty() || (less != std::string::npos && role.parent.empty())) {
+            error = "line " + std::to_string(lineNumber) + ": missing role name";
+            return false;
+        }
+        if (roles.count(name)) {
+            error = "line " + std::to_string(lineNumber) + ": role '" + name + "' declared twice";
+            return false;
+        }
+
+        std::istringstream permissions(line.substr(colon + 1));
+        std::string word;
+        while (permissions >> word) {
+            Permission permission;
+            if (!parsePermission(word, permission)) {
+                error = "line " + std::to_string(lineNumber) + ": unknown permission '" + word + "'";
+                return false;
+            }
+            role.own |= permissionBit(permission);
+        }
+        roles[name] = role;
+        order.push_back(name);
+    }
+
+    // Every role becomes one mask, so checks never walk the inheritance chain
+    for (const std::string& name : order) {
+        if (!resolve(name, roles, policy, error)) {
+            policy.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+PermissionMask policyMask(const Policy& policy, const std::string& role) {
+    auto found = policy.find(role);
+    return found == policy.end() ? 0 : found->second;
+}
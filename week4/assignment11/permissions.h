@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+/*
+This header file defines roles and permissions as bitmasks.
+
+Every Permission is one bit. A role is declared at compile time as its
+parent role plus the permissions it adds:
+
+    using EmployeeRole = Role<UserRole, Permission::EditInventory>;
+
+and Role<...>::mask is the constexpr union of its own bits and every
+ancestor's, computed by the compiler. Checking a permission is then one
+AND against a mask held by the user, with no virtual call and no walk up
+the role chain.
+
+A policy loaded at run time (parsePolicy) is resolved the same way, once,
+into one mask per role name, so checks against it cost the same as
+against a compiled role. Policy text has one role per line:
+
+    # comment
+    user: view_inventory view_accounts
+    employee < user: edit_inventory deposit
+*/
+
+enum class Permission : uint32_t {
+    ViewInventory,
+    EditInventory,
+    RemoveInventory,
+    ReserveStock,
+    ViewAccounts,
+    Deposit,
+    Withdraw,
+    Transfer,
+    ViewReports,
+    ManageUsers,
+};
+
+using PermissionMask = uint64_t;
+
+constexpr PermissionMask permissionBit(Permission permission) {
+    return (PermissionMask)1 << (uint32_t)permission;
+}
+
+// Union of the given permissions' bits
+template <Permission... Permissions>
+constexpr PermissionMask permissionMask = (PermissionMask(0) | ... | permissionBit(Permissions));
+
+// True if granted has every bit of required (a single permission is one AND)
+constexpr bool allows(PermissionMask granted, PermissionMask required) {
+    return (granted & required) == required;
+}
+
+// ---------------------------------------------------------------- Compile-time roles
+
+struct NoRole {
+    static constexpr PermissionMask mask = 0;
+};
+
+// A role with everything Parent has plus Added
+template <typename Parent, Permission... Added>
+struct Role {
+    using parent = Parent;
+    static constexpr PermissionMask mask = Parent::mask | permissionMask<Added...>;
+};
+
+using UserRole = Role<NoRole, Permission::ViewInventory>;
+using EmployeeRole = Role<UserRole, Permission::EditInventory, Permission::ReserveStock, Permission::Deposit>;
+using InventoryManagerRole = Role<EmployeeRole, Permission::RemoveInventory, Permission::ViewReports>;
+
+static_assert(allows(InventoryManagerRole::mask, permissionBit(Permission::ViewInventory)),
+              "A role inherits its parent's permissions");
+static_assert(!allows(UserRole::mask, permissionBit(Permission::EditInventory)), "Parents do not gain child permissions");
+
+// Known at compile time for a compiled role, e.g. static_assert(roleAllows<EmployeeRole, Permission::Deposit>)
+template <typename R, Permission P>
+constexpr bool roleAllows = allows(R::mask, permissionBit(P));
+
+// ---------------------------------------------------------------- Runtime policy
+
+const char* permissionName(Permission permission);                 // "view_inventory", ...
+bool parsePermission(const std::string& name, Permission& permission); // False for an unknown name
+
+// Role name -> mask with inherited permissions included
+using Policy = std::unordered_map<std::string, PermissionMask>;
+
+// Parses policy text (see above). A parent may be declared before or after its children. False,
+// with a message in error, for an unknown permission or parent, a role declared twice or an
+// inheritance cycle.
+bool parsePolicy(const std::string& text, Policy& policy, std::string& error);
+
+// The mask of a role in a policy; 0 (nothing allowed) for an unknown role
+PermissionMask policyMask(const Policy& policy, const std::string& role);
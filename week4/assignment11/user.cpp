@@ -1,5 +1,9 @@
 #include "user.h"
 
+User::User() : permissions(UserRole::mask) {}
+
+User::User(PermissionMask mask) : permissions(mask) {}
+
 void User::accessLevel() {
     cout << "General Access\n";
 }
@@ -1,8 +1,20 @@
 #pragma once
 #include <iostream>
+#include "permissions.h"
 using namespace std;
 
 class User {
+protected:
+    PermissionMask permissions; // Everything this user may do, inherited permissions included
+
 public:
+    User();
+    explicit User(PermissionMask mask); // E.g. a role's mask from a loaded policy
+
     virtual void accessLevel();
+
+    // One AND; not virtual, so it is cheap enough for every inventory or account change
+    bool can(Permission permission) const {
+        return (permissions & permissionBit(permission)) != 0;
+    }
 };
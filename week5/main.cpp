@@ -1,71 +1,325 @@
 #include <iostream>
-#include <fstream>
-#include <sstream>
-#include <vector>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <string>
 #include "student.h"
+#include "studentcache.h"
+#include "studentfilter.h"
+#include "studentfollow.h"
+#include "studentgroupby.h"
+#include "studentjoin.h"
+#include "studentmodel.h"
+#include "studentsort.h"
+#include "studenttable.h"
 
 /*
-This program reads student placement data from a CSV file,
-creates Student objects for each row, and displays their information.
+This program reads student placement data from a CSV file into a
+column-oriented StudentTable, reports how fast the whole file was
+loaded, and displays the first few students. The parsed table is cached
+next to the CSV (file.csv.stcache) and later runs map the cache instead
+of parsing again until the CSV changes; --no-cache always parses. With --filter it displays
+the first few students matching a query instead, e.g.
+    main data.csv --filter "cgpa > 8 && internship && communication_skills >= 7"
+With --group it prints per-group statistics of the --value column
+(placement by default) over the matching students instead, e.g.
+    main data.csv --group iq:10 --value placement
+With --sort it ranks the matching students by one or more columns and
+shows the first ten (or the first N of a top-N ranking with --top N), e.g.
+    main data.csv --sort cgpa:desc,iq:desc,projects_completed:desc --top 20
+With --join it matches students with the rows of another College_ID-keyed
+CSV file and writes the joined rows to --out (or shows the first ten), e.g.
+    main data.csv --join offers.csv --left --out joined.csv
+With --follow it keeps reading rows appended to the file and prints the
+updated placement summary after every batch, until interrupted.
+With --export it writes every matching (or sorted) student as csv, tsv,
+jsonl or aligned text to --out, or to the console, e.g.
+    main data.csv --filter "placement" --export jsonl --out placed.jsonl
+With --predict it cross-validates a placement model (logistic or knn,
+with --folds N and --k N) and shows the predicted placement probability
+of the first ten students, e.g.
+    main data.csv --predict knn --folds 5 --k 5
+Usage: main [file.csv] [--filter "query"] [--group key[:width],...] [--value column]
+            [--sort key[:desc],...] [--top N] [--join other.csv [--left] [--out file.csv]]
+            [--export csv|tsv|jsonl|text [--out file]]
+            [--no-cache] [--follow] [--predict logistic|knn [--folds N] [--k N]] [--threads N]
 */
 
-int main() {
-    std::ifstream file("college_student_placement_dataset.csv");
-    if (!file.is_open()) {
+int main(int argc, char* argv[]) {
+    std::string path = "college_student_placement_dataset.csv";
+    std::string filter, group, value = "placement", sort, join, outPath, predict, exportAs;
+    bool leftJoin = false, follow = false, useCache = true;
+    int threads = 0;
+    size_t top = 0; // 0: sort every matching row and show the first ten
+    size_t folds = 5;
+    int k = 5;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) filter = argv[++i];
+        else if (arg == "--group" && i + 1 < argc) group = argv[++i];
+        else if (arg == "--value" && i + 1 < argc) value = argv[++i];
+        else if (arg == "--sort" && i + 1 < argc) sort = argv[++i];
+        else if (arg == "--top" && i + 1 < argc) top = (size_t)std::atoll(argv[++i]);
+        else if (arg == "--join" && i + 1 < argc) join = argv[++i];
+        else if (arg == "--left") leftJoin = true;
+        else if (arg == "--out" && i + 1 < argc) outPath = argv[++i];
+        else if (arg == "--follow") follow = true;
+        else if (arg == "--no-cache") useCache = false;
+        else if (arg == "--export" && i + 1 < argc) exportAs = argv[++i];
+        else if (arg == "--predict" && i + 1 < argc) predict = argv[++i];
+        else if (arg == "--folds" && i + 1 < argc) folds = (size_t)std::atoll(argv[++i]);
+        else if (arg == "--k" && i + 1 < argc) k = std::atoi(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) threads = std::atoi(argv[++i]);
+        else path = arg;
+    }
+
+    ReportFormat exportFormat = ReportFormat::Csv;
+    if (!exportAs.empty() && !parseReportFormat(exportAs, exportFormat)) {
+        std::cerr << "Bad --export format: use csv, tsv, jsonl or text.\n";
+        return 1;
+    }
+
+    StudentTable students; // Every row of the file, one vector per field
+    LoadStats stats;
+
+    if (follow) {
+        StudentFollower follower(path);
+        PlacementSummary summary;
+        follower.addAggregate(summary);
+        if (!follower.open(students, threads)) {
+            std::cerr << "Error opening file.\n";
+            return 1;
+        }
+
+        // One line per batch of appended rows; old rows are never read again
+        auto report = [&](size_t added) {
+            std::cout << "+" << added << " -> " << summary.count << " students, "
+                      << std::setprecision(4) << summary.placementRate() * 100 << "% placed, mean CGPA "
+                      << summary.meanCgpa() << ", mean IQ " << summary.meanIq() << ", offset "
+                      << follower.consumedOffset() << " (" << follower.badRowCount() << " bad rows)" << std::endl;
+        };
+        report(students.size());
+        size_t resets = 0;
+        while (true) {
+            size_t added = follower.wait(1000);
+            if (follower.resetCount() != resets) {
+                resets = follower.resetCount();
+                std::cout << "File shrank or was replaced; reading it again from the start" << std::endl;
+            }
+            if (added > 0) report(added);
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool fromCache = false;
+    bool loaded = useCache ? loadStudentTableCached(path, students, stats, fromCache, threads)
+                           : loadStudentTable(path, students, stats, threads);
+    if (!loaded) {
         std::cerr << "Error opening file.\n";
         return 1;
     }
+    auto stop = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(stop - start).count();
+
+    std::cout << "Loaded " << stats.rows << " students (" << stats.badRows << " bad rows skipped) "
+              << (fromCache ? "from the cache " : "") << "in " << seconds * 1000 << " ms";
+    if (seconds > 0) std::cout << ", " << (size_t)(stats.rows / seconds) << " rows/sec";
+    std::cout << "\n";
+    if (!stats.headerError.empty()) std::cerr << "Warning: " << path << ": " << stats.headerError << "\n";
+
+    if (!join.empty()) {
+        AuxTable other;
+        LoadStats otherStats;
+        if (!loadAuxTable(join, other, otherStats)) {
+            std::cerr << "Cannot read " << join << " or it has no College_ID column.\n";
+            return 1;
+        }
+        std::cout << "Loaded " << otherStats.rows << " rows from " << join << " (" << otherStats.badRows
+                  << " bad rows skipped)\n";
+
+        JoinOptions options;
+        options.type = leftJoin ? JoinType::Left : JoinType::Inner;
+        options.threads = threads;
+        start = std::chrono::steady_clock::now();
+        JoinResult joined = joinStudents(students, other, options);
+        stop = std::chrono::steady_clock::now();
+        double micros = std::chrono::duration<double, std::micro>(stop - start).count();
+        std::cout << joined.size() << " joined rows (" << micros << " us, ~" << joined.distinctEstimate
+                  << " distinct keys, " << joined.partitions << " partitions)\n";
+
+        if (!outPath.empty()) {
+            if (!writeJoinCsv(outPath, students, other, joined)) {
+                std::cerr << "Cannot write " << outPath << ".\n";
+                return 1;
+            }
+            return 0;
+        }
+        for (size_t i = 0; i < joined.size() && i < 10; i++) {
+            students.student(joined.left[i]).display();
+            for (size_t c = 0; c < other.columns.size(); c++) {
+                if (c == other.keyColumn) continue;
+                std::cout << "    " << other.columns[c] << ": "
+                          << (joined.right[i] == NoMatch ? "" : other.field(joined.right[i], c)) << "\n";
+            }
+        }
+        return 0;
+    }
+
+    if (!predict.empty()) {
+        if (predict != "logistic" && predict != "knn") {
+            std::cerr << "Bad --predict model: use logistic or knn.\n";
+            return 1;
+        }
+        ModelKind kind = predict == "knn" ? ModelKind::Knn : ModelKind::Logistic;
+
+        start = std::chrono::steady_clock::now();
+        CrossValidation cv = crossValidate(students, kind, folds, k, threads);
+        stop = std::chrono::steady_clock::now();
+        double millis = std::chrono::duration<double, std::milli>(stop - start).count();
+        std::cout << cv.folds << "-fold accuracy " << cv.accuracy * 100 << "% (always guessing the majority: "
+                  << cv.baseline * 100 << "%), " << modelKernelName() << " kernels, " << millis << " ms\n";
+
+        // Train on every row, then score the whole table in one batch
+        std::vector<float> scores;
+        start = std::chrono::steady_clock::now();
+        if (kind == ModelKind::Logistic) {
+            LogisticModel model;
+            LogisticOptions options;
+            options.threads = threads;
+            model.train(students, nullptr, options);
+            scores = model.score(students, nullptr, threads);
+        } else {
+            KnnModel model;
+            model.k = k;
+            model.train(students);
+            scores = model.score(students, nullptr, threads);
+        }
+        stop = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        std::cout << "Trained and scored " << scores.size() << " students in " << seconds * 1000 << " ms";
+        if (seconds > 0) std::cout << ", " << (size_t)(scores.size() / seconds) << " rows/sec";
+        std::cout << "\n";
+
+        for (size_t i = 0; i < students.size() && i < 10; i++) {
+            students.student(i).display();
+            std::cout << "Predicted placement: " << std::round(scores[i] * 1000) / 10 << "%\n";
+        }
+        return 0;
+    }
+
+    // Writes rows (every row if nullptr) to --out or the console in the --export format
+    auto exportRows = [&](const std::vector<uint32_t>* rows) {
+        ReportWriter out;
+        if (outPath.empty()) {
+            std::cout << std::flush; // Earlier messages first; the report bypasses std::cout
+            out.attach(1);
+        } else if (!out.open(outPath)) {
+            std::cerr << "Cannot write " << outPath << ".\n";
+            return 1;
+        }
+        auto begin = std::chrono::steady_clock::now();
+        writeStudentReport(out, exportFormat, students, rows);
+        bool written = out.close();
+        double millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        if (!written) {
+            std::cerr << "Writing the report failed.\n";
+            return 1;
+        }
+        std::cerr << "Exported " << (rows ? rows->size() : students.size()) << " students in " << millis << " ms ("
+                  << out.writeCalls() << " writes)\n";
+        return 0;
+    };
+
+    if (filter.empty() && group.empty() && sort.empty()) {
+        if (!exportAs.empty()) return exportRows(nullptr);
+
+        // Display a preview of the data
+        for (size_t i = 0; i < students.size() && i < 10; i++) {
+            students.student(i).display();
+        }
+        return 0;
+    }
+
+    Selection matches(students.size(), true);
+    if (!filter.empty()) {
+        StudentQuery query;
+        std::string error;
+        if (!StudentQuery::parse(filter, query, error)) {
+            std::cerr << "Bad filter: " << error << "\n";
+            return 1;
+        }
+
+        StudentIndex index; // Bitmaps for the Yes/No and 0-10 score columns
+        index.build(students);
+
+        start = std::chrono::steady_clock::now();
+        matches = query.run(students, &index);
+        stop = std::chrono::steady_clock::now();
+        double micros = std::chrono::duration<double, std::micro>(stop - start).count();
+        std::cout << matches.count() << " of " << students.size() << " students match (" << micros << " us)\n";
+    }
+
+    if (!group.empty()) {
+        std::vector<GroupKey> keys;
+        StudentColumn valueColumn;
+        if (!parseGroupKeys(group, keys) || !studentColumnByName(value, valueColumn)) {
+            std::cerr << "Bad --group or --value column.\n";
+            return 1;
+        }
+
+        GroupByOptions options;
+        options.filter = filter.empty() ? nullptr : &matches;
+        options.threads = threads;
+        std::vector<GroupResult> groups;
+        start = std::chrono::steady_clock::now();
+        if (!groupStudents(students, keys, valueColumn, groups, options)) {
+            std::cerr << "Cannot group by " << group << ".\n";
+            return 1;
+        }
+        stop = std::chrono::steady_clock::now();
+        double micros = std::chrono::duration<double, std::micro>(stop - start).count();
+        std::cout << groups.size() << " groups (" << micros << " us)\n";
+
+        // One row per group: key lower bounds, then statistics of the value column
+        for (const GroupKey& key : keys) std::cout << std::setw(22) << studentColumnName(key.column);
+        std::cout << std::setw(10) << "count" << std::setw(12) << "mean" << std::setw(10) << "min"
+                  << std::setw(10) << "max" << std::setw(12) << "stddev" << "\n";
+        for (const GroupResult& g : groups) {
+            for (size_t k = 0; k < keys.size(); k++) std::cout << std::setw(22) << g.key[k];
+            std::cout << std::setw(10) << g.count << std::setw(12) << g.mean << std::setw(10) << g.min
+                      << std::setw(10) << g.max << std::setw(12) << std::sqrt(g.variance()) << "\n";
+        }
+        return 0;
+    }
+
+    if (!sort.empty()) {
+        std::vector<SortKey> keys;
+        if (!parseSortKeys(sort, keys)) {
+            std::cerr << "Bad --sort keys.\n";
+            return 1;
+        }
+
+        const Selection* only = filter.empty() ? nullptr : &matches;
+        start = std::chrono::steady_clock::now();
+        std::vector<uint32_t> ranked = top > 0 ? topStudents(students, keys, top, only, threads)
+                                               : sortStudents(students, keys, only, threads);
+        stop = std::chrono::steady_clock::now();
+        double micros = std::chrono::duration<double, std::micro>(stop - start).count();
+        std::cout << (top > 0 ? "Top " : "Sorted ") << ranked.size() << " students (" << micros << " us)\n";
+        if (!exportAs.empty()) return exportRows(&ranked);
 
-    std::vector<Student> students; // Dynamic array to hold Student objects
-
-    std::string line;
-    std::getline(file, line); // Skip header row
-
-    int count = 0;
-    while (std::getline(file, line) && count < 10) {
-        std::stringstream ss(line);
-
-        // Temporary strings for each field
-        std::string c_id, iq_str, prev_res_str, cgpa_str, a_perf_str,
-                    intern_exp_str, e_score_str, com_skills_str,
-                    proj_comp_str, placement_str;
-
-        // Extract each comma-separated field
-        std::getline(ss, c_id, ',');
-        std::getline(ss, iq_str, ',');
-        std::getline(ss, prev_res_str, ',');
-        std::getline(ss, cgpa_str, ',');
-        std::getline(ss, a_perf_str, ',');
-        std::getline(ss, intern_exp_str, ',');
-        std::getline(ss, e_score_str, ',');
-        std::getline(ss, com_skills_str, ',');
-        std::getline(ss, proj_comp_str, ',');
-        std::getline(ss, placement_str, ',');
-
-        // Convert strings to appropriate data types
-        int iq = std::stoi(iq_str);
-        double prev_res = std::stod(prev_res_str);
-        double cgpa = std::stod(cgpa_str);
-        int a_perf = std::stoi(a_perf_str);
-        bool intern_exp = (intern_exp_str == "Yes");
-        int e_score = std::stoi(e_score_str);
-        int com_skills = std::stoi(com_skills_str);
-        int proj_comp = std::stoi(proj_comp_str);
-        bool place = (placement_str == "Yes");
-
-        // Create Student object using constructor
-        Student s(c_id, iq, prev_res, cgpa, a_perf,
-                  intern_exp, e_score, com_skills, proj_comp, place);
-
-        // Add Student to vector
-        students.push_back(s);
-
-        count++;
+        size_t shown = top > 0 ? top : 10;
+        for (size_t i = 0; i < ranked.size() && i < shown; i++) {
+            students.student(ranked[i]).display();
+        }
+        return 0;
     }
 
-    // Loop over all students and display their data
-    for (const auto& s : students) {
-        s.display();
+    std::vector<uint32_t> rows = matches.toRows();
+    if (!exportAs.empty()) return exportRows(&rows);
+    for (size_t i = 0; i < rows.size() && i < 10; i++) {
+        students.student(rows[i]).display();
     }
 
     return 0;
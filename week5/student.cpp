@@ -42,5 +42,5 @@ void Student::display() const {
               << ", Communication Skills: " << communication_skills
               << ", Projects Completed: " << projects_completed
               << ", Placement: " << (placement ? "Yes" : "No")
-              << std::endl;
+              << '\n'; // No flush per student; the stream flushes when its buffer fills
 }
@@ -0,0 +1,231 @@
+#include "studentcache.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+#include "../common/mappedfile.h"
+
+/*
+This source file implements the StudentTable cache file declared in
+studentcache.h.
+*/
+
+const char CacheMagic[8] = {'S', 'T', 'C', 'A', 'C', 'H', 'E', 0};
+const uint32_t CacheVersion = 1;
+const uint32_t ByteOrderMark = 0x01020304; // Reads back differently on a machine of the other endianness
+const int ColumnCount = 11;
+const size_t ColumnAlign = 64;              // Every column starts on a cache line
+const size_t SampleBytes = 4096;            // Size of each hashed sample of the CSV
+const size_t SampleCount = 16;              // Samples from the first to the last byte
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t sourceSize;             // Bytes in the CSV
+    int64_t sourceTime;              // CSV modification time (filesystem clock ticks)
+    uint64_t sourceHash;             // Hash of SampleCount samples of the CSV
+    uint64_t rows;
+    uint64_t idBytes;                // Size of the College ID arena
+    uint64_t badRows;                // Malformed rows skipped when the CSV was parsed
+    uint64_t offsets[ColumnCount];   // File offset of each column (see forEachColumn)
+    uint64_t fileBytes;              // Size of the whole cache file
+};
+
+// Identifies the CSV contents a cache was built from
+struct SourceKey {
+    uint64_t size = 0;  // Bytes in the CSV
+    int64_t time = 0;   // Modification time (filesystem clock ticks)
+    uint64_t hash = 0;  // Hash of SampleCount samples of the contents
+};
+
+// ---------------------------------------------------------------- Layout
+
+// Calls fn(index, column) for every column of the table in file order
+template <typename Table, typename Fn>
+static void forEachColumn(Table& table, Fn fn) {
+    fn(0, table.iq);
+    fn(1, table.prev_sem_result);
+    fn(2, table.cgpa);
+    fn(3, table.academic_performance);
+    fn(4, table.internship_experience);
+    fn(5, table.extra_curricular_score);
+    fn(6, table.communication_skills);
+    fn(7, table.projects_completed);
+    fn(8, table.placement);
+    fn(9, table.id_arena);
+    fn(10, table.id_offsets);
+}
+
+// Values in a column: one per row, except the arena and the offsets (one more than the rows)
+static uint64_t columnCount(int column, uint64_t rows, uint64_t idBytes) {
+    if (column == 9) return idBytes;
+    if (column == 10) return rows + 1;
+    return rows;
+}
+
+static uint64_t alignUp(uint64_t offset) {
+    return (offset + ColumnAlign - 1) / ColumnAlign * ColumnAlign;
+}
+
+// ---------------------------------------------------------------- Source key
+
+// Hash of SampleCount evenly spaced SampleBytes pieces (the first and last included), or of the
+// whole text if it is smaller; catches edits that keep the size and modification time
+static uint64_t sampleHash(const char* data, size_t size) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ size;
+    auto mix = [&](const char* p, size_t n) {
+        for (; n >= 8; p += 8, n -= 8) {
+            uint64_t word;
+            std::memcpy(&word, p, 8);
+            h = (h ^ word) * 0x100000001B3ull;
+            h ^= h >> 29;
+        }
+        for (; n > 0; p++, n--) h = (h ^ (unsigned char)*p) * 0x100000001B3ull;
+    };
+    if (size <= SampleCount * SampleBytes) {
+        mix(data, size);
+    } else {
+        for (size_t s = 0; s < SampleCount; s++) {
+            mix(data + (size - SampleBytes) * s / (SampleCount - 1), SampleBytes);
+        }
+    }
+    return h;
+}
+
+// False if the CSV cannot be read
+static bool sourceKey(const std::string& csvPath, SourceKey& key) {
+    std::error_code error;
+    auto modified = std::filesystem::last_write_time(csvPath, error);
+    if (error) return false;
+    key.time = (int64_t)modified.time_since_epoch().count();
+
+    MappedFile csv;
+    if (!csv.open(csvPath)) return false;
+    key.size = csv.size();
+    key.hash = sampleHash(csv.data(), csv.size());
+    return true;
+}
+
+// ---------------------------------------------------------------- Cache file
+
+std::string studentCachePath(const std::string& csvPath) {
+    return csvPath + ".stcache";
+}
+
+bool loadStudentCache(const std::string& csvPath, StudentTable& table, LoadStats& stats) {
+    auto cache = std::make_shared<MappedFile>();
+    if (!cache->open(studentCachePath(csvPath)) || cache->size() < sizeof(CacheHeader)) return false;
+    CacheHeader header;
+    std::memcpy(&header, cache->data(), sizeof(header));
+    if (std::memcmp(header.magic, CacheMagic, sizeof(CacheMagic)) != 0 || header.version != CacheVersion ||
+        header.byteOrder != ByteOrderMark || header.fileBytes != cache->size()) {
+        return false;
+    }
+
+    SourceKey key;
+    if (!sourceKey(csvPath, key)) return false;
+    if (key.size != header.sourceSize || key.time != header.sourceTime || key.hash != header.sourceHash) {
+        return false; // The CSV changed since the cache was written
+    }
+
+    // Every column must lie inside the file, aligned, where the writer would have put it
+    if (header.rows >= UINT32_MAX || header.idBytes >= UINT32_MAX) return false;
+    bool valid = true;
+    uint64_t end = sizeof(CacheHeader);
+    forEachColumn(table, [&](int i, const auto& column) {
+        using T = std::decay_t<decltype(column[0])>;
+        uint64_t offset = alignUp(end);
+        valid = valid && header.offsets[i] == offset;
+        end = offset + columnCount(i, header.rows, header.idBytes) * sizeof(T);
+    });
+    if (!valid || end != header.fileBytes) return false;
+
+    const char* base = cache->data();
+    const uint32_t* offsets = (const uint32_t*)(base + header.offsets[10]);
+    if (offsets[0] != 0 || offsets[header.rows] != header.idBytes) return false;
+
+    table.clear();
+    forEachColumn(table, [&](int i, auto& column) {
+        using T = std::decay_t<decltype(column[0])>;
+        uint64_t count = columnCount(i, header.rows, header.idBytes);
+        column = Column<T>::viewOf((const T*)(base + header.offsets[i]), (size_t)count);
+    });
+    table.backing = cache; // The columns read the mapping; it stays open as long as they do
+
+    stats.rows = header.rows;
+    stats.badRows = header.badRows;
+    stats.bytes = header.sourceSize;
+    stats.headerError.clear();
+    return true;
+}
+
+// Writes the cache under the key of the CSV contents the table was parsed from
+static bool writeCache(const std::string& csvPath, const StudentTable& table, const LoadStats& stats,
+                       const SourceKey& key) {
+    CacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CacheMagic, sizeof(CacheMagic));
+    header.version = CacheVersion;
+    header.byteOrder = ByteOrderMark;
+    header.sourceSize = key.size;
+    header.sourceTime = key.time;
+    header.sourceHash = key.hash;
+    header.rows = table.size();
+    header.idBytes = table.id_arena.size();
+    header.badRows = stats.badRows;
+
+    uint64_t end = sizeof(CacheHeader);
+    forEachColumn(table, [&](int i, const auto& column) {
+        header.offsets[i] = alignUp(end);
+        end = header.offsets[i] + column.size() * sizeof(column[0]);
+    });
+    header.fileBytes = end;
+
+    // Written beside the old cache and renamed over it, so a reader never sees half a file
+    std::string path = studentCachePath(csvPath), temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write((const char*)&header, sizeof(header));
+        uint64_t position = sizeof(header);
+        const char padding[ColumnAlign] = {};
+        forEachColumn(table, [&](int i, const auto& column) {
+            out.write(padding, (std::streamsize)(header.offsets[i] - position));
+            out.write((const char*)column.data(), (std::streamsize)(column.size() * sizeof(column[0])));
+            position = header.offsets[i] + column.size() * sizeof(column[0]);
+        });
+        if (!out.flush()) {
+            out.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool saveStudentCache(const std::string& csvPath, const StudentTable& table, const LoadStats& stats) {
+    SourceKey key;
+    return sourceKey(csvPath, key) && writeCache(csvPath, table, stats, key);
+}
+
+bool loadStudentTableCached(const std::string& path, StudentTable& table, LoadStats& stats, bool& fromCache,
+                            int threads) {
+    fromCache = loadStudentCache(path, table, stats);
+    if (fromCache) return true;
+
+    // Keyed before parsing: if the CSV changes meanwhile, the cache is stale on the next run
+    SourceKey key;
+    bool keyed = sourceKey(path, key);
+    if (!loadStudentTable(path, table, stats, threads)) return false;
+    if (keyed && stats.headerError.empty()) writeCache(path, table, stats, key); // No cache if the directory is read-only
+    return true;
+}
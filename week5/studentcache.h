@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include "studenttable.h"
+
+/*
+This header file defines the binary cache of a parsed placement CSV.
+
+The cache is written next to the CSV (data.csv -> data.csv.stcache) and
+holds every StudentTable column exactly as it sits in memory, each one
+starting on a 64-byte boundary after a fixed header. The header records
+the CSV's size, modification time and a hash of evenly spaced samples of
+its contents; if any of them no longer match, the cache is stale and the
+CSV is parsed again.
+
+Reloading maps the cache file and checks its header. The columns then
+view the mapping directly (see Column), so nothing is parsed or copied
+and the reload takes the same time whatever the row count. Pages are
+read in when a column is first scanned. Cache files are native-endian
+and are simply rebuilt on a machine that cannot read them.
+*/
+
+// Path of the cache file for a CSV
+std::string studentCachePath(const std::string& csvPath);
+
+// Maps a valid, up-to-date cache of csvPath into table (replacing its contents). False if there is
+// no cache or it is stale, damaged or from another format version.
+bool loadStudentCache(const std::string& csvPath, StudentTable& table, LoadStats& stats);
+
+// Writes the cache of csvPath for a table parsed from it (written to a temporary file, then renamed
+// over the old cache). False if it cannot be written.
+bool saveStudentCache(const std::string& csvPath, const StudentTable& table, const LoadStats& stats);
+
+// Loads from the cache when it is current; otherwise parses the CSV and rewrites the cache (unless
+// the header did not match). fromCache tells which happened. False if the CSV cannot be opened.
+bool loadStudentTableCached(const std::string& path, StudentTable& table, LoadStats& stats, bool& fromCache,
+                            int threads = 0);
@@ -0,0 +1,447 @@
+#include "studentfilter.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include "../common/cpu.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define STUDENT_FILTER_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+This source file implements the selection bitmaps, comparison kernels,
+bitmap index and query parser declared in studentfilter.h.
+*/
+
+// ---------------------------------------------------------------- Selection
+
+Selection::Selection(size_t rowCount, bool selected) {
+    rows = rowCount;
+    words.assign((rowCount + 63) / 64, selected ? ~0ull : 0ull);
+    if (selected && rowCount % 64 != 0) {
+        words.back() = (1ull << (rowCount % 64)) - 1; // No bits past the last row
+    }
+}
+
+size_t Selection::count() const {
+    size_t total = 0;
+    for (uint64_t w : words) {
+#if defined(_MSC_VER)
+        total += (size_t)__popcnt64(w);
+#else
+        total += (size_t)__builtin_popcountll(w);
+#endif
+    }
+    return total;
+}
+
+bool Selection::test(size_t row) const {
+    return (words[row / 64] >> (row % 64)) & 1;
+}
+
+void Selection::andWith(const Selection& other) {
+    for (size_t i = 0; i < words.size(); i++) words[i] &= other.words[i];
+}
+
+void Selection::orWith(const Selection& other) {
+    for (size_t i = 0; i < words.size(); i++) words[i] |= other.words[i];
+}
+
+std::vector<uint32_t> Selection::toRows() const {
+    std::vector<uint32_t> result;
+    result.reserve(count());
+    for (size_t i = 0; i < words.size(); i++) {
+        uint64_t w = words[i];
+        while (w) {
+#if defined(_MSC_VER)
+            unsigned long bit;
+            _BitScanForward64(&bit, w);
+#else
+            int bit = __builtin_ctzll(w);
+#endif
+            result.push_back((uint32_t)(i * 64 + bit));
+            w &= w - 1; // Clear the lowest set bit
+        }
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------- Integer predicate normalization
+
+// Integer columns only need >, <, == and != against an integer constant.
+// Returns 1 or 0 when the predicate is constant true/false over every possible value, -1 otherwise.
+static int normalizeInteger(CompareOp op, double value, long long lo, long long hi,
+                            CompareOp& outOp, long long& outValue) {
+    if (std::isnan(value)) return op == CompareOp::NotEqual ? 1 : 0; // As a double comparison would
+    // Past the column's range every answer is already constant; clamping keeps the casts below defined
+    value = std::min(std::max(value, (double)lo - 1), (double)hi + 1);
+    switch (op) {
+    case CompareOp::Greater:      outOp = CompareOp::Greater; outValue = (long long)std::floor(value); break;
+    case CompareOp::GreaterEqual: outOp = CompareOp::Greater; outValue = (long long)std::ceil(value) - 1; break;
+    case CompareOp::Less:         outOp = CompareOp::Less;    outValue = (long long)std::ceil(value); break;
+    case CompareOp::LessEqual:    outOp = CompareOp::Less;    outValue = (long long)std::floor(value) + 1; break;
+    case CompareOp::Equal:
+    case CompareOp::NotEqual:
+        if (value != std::floor(value) || value < lo || value > hi) return op == CompareOp::NotEqual ? 1 : 0;
+        outOp = op;
+        outValue = (long long)value;
+        return -1;
+    }
+    if (outOp == CompareOp::Greater) {
+        if (outValue >= hi) return 0;
+        if (outValue < lo) return 1;
+    } else {
+        if (outValue > hi) return 1;
+        if (outValue <= lo) return 0;
+    }
+    return -1;
+}
+
+template <typename T>
+static bool holds(T x, CompareOp op, T v) {
+    switch (op) {
+    case CompareOp::Less:         return x < v;
+    case CompareOp::LessEqual:    return x <= v;
+    case CompareOp::Greater:      return x > v;
+    case CompareOp::GreaterEqual: return x >= v;
+    case CompareOp::Equal:        return x == v;
+    default:                      return x != v;
+    }
+}
+
+// ---------------------------------------------------------------- Portable kernels
+
+// Branch-free bit packing; compilers vectorize the inner loop
+template <typename T>
+static void compareScalar(const T* x, size_t n, CompareOp op, T v, uint64_t* out) {
+    size_t full = n / 64;
+    for (size_t w = 0; w < full; w++) {
+        const T* p = x + w * 64;
+        uint64_t bits = 0;
+        switch (op) {
+        case CompareOp::Less:         for (int j = 0; j < 64; j++) bits |= (uint64_t)(p[j] < v) << j; break;
+        case CompareOp::LessEqual:    for (int j = 0; j < 64; j++) bits |= (uint64_t)(p[j] <= v) << j; break;
+        case CompareOp::Greater:      for (int j = 0; j < 64; j++) bits |= (uint64_t)(p[j] > v) << j; break;
+        case CompareOp::GreaterEqual: for (int j = 0; j < 64; j++) bits |= (uint64_t)(p[j] >= v) << j; break;
+        case CompareOp::Equal:        for (int j = 0; j < 64; j++) bits |= (uint64_t)(p[j] == v) << j; break;
+        case CompareOp::NotEqual:     for (int j = 0; j < 64; j++) bits |= (uint64_t)(p[j] != v) << j; break;
+        }
+        out[w] = bits;
+    }
+    if (n % 64 != 0) {
+        uint64_t bits = 0;
+        for (size_t j = full * 64; j < n; j++) bits |= (uint64_t)holds(x[j], op, v) << (j % 64);
+        out[full] = bits;
+    }
+}
+
+// ---------------------------------------------------------------- AVX2 kernels
+
+#ifdef STUDENT_FILTER_X86
+
+#if defined(__GNUC__) || defined(__clang__)
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
+
+// 8 int32 per vector; op is Greater, Less, Equal or NotEqual after normalization
+AVX2_TARGET static void compareI32Avx2(const int32_t* x, size_t n, CompareOp op, int32_t v, uint64_t* out) {
+    __m256i value = _mm256_set1_epi32(v);
+    size_t full = n / 64;
+    for (size_t w = 0; w < full; w++) {
+        uint64_t bits = 0;
+        for (int k = 0; k < 8; k++) {
+            __m256i a = _mm256_loadu_si256((const __m256i*)(x + w * 64 + k * 8));
+            __m256i m;
+            if (op == CompareOp::Greater) m = _mm256_cmpgt_epi32(a, value);
+            else if (op == CompareOp::Less) m = _mm256_cmpgt_epi32(value, a);
+            else m = _mm256_cmpeq_epi32(a, value);
+            uint64_t mask = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(m));
+            bits |= mask << (k * 8);
+        }
+        out[w] = op == CompareOp::NotEqual ? ~bits : bits;
+    }
+    if (n % 64 != 0) compareScalar(x + full * 64, n % 64, op, v, out + full);
+}
+
+// 4 doubles per vector, ordered comparisons (NaN never matches except for !=)
+AVX2_TARGET static void compareF64Avx2(const double* x, size_t n, CompareOp op, double v, uint64_t* out) {
+    __m256d value = _mm256_set1_pd(v);
+    size_t full = n / 64;
+    for (size_t w = 0; w < full; w++) {
+        uint64_t bits = 0;
+        for (int k = 0; k < 16; k++) {
+            __m256d a = _mm256_loadu_pd(x + w * 64 + k * 4);
+            __m256d m;
+            switch (op) {
+            case CompareOp::Less:         m = _mm256_cmp_pd(a, value, _CMP_LT_OQ); break;
+            case CompareOp::LessEqual:    m = _mm256_cmp_pd(a, value, _CMP_LE_OQ); break;
+            case CompareOp::Greater:      m = _mm256_cmp_pd(a, value, _CMP_GT_OQ); break;
+            case CompareOp::GreaterEqual: m = _mm256_cmp_pd(a, value, _CMP_GE_OQ); break;
+            case CompareOp::Equal:        m = _mm256_cmp_pd(a, value, _CMP_EQ_OQ); break;
+            default:                      m = _mm256_cmp_pd(a, value, _CMP_NEQ_UQ); break;
+            }
+            bits |= (uint64_t)_mm256_movemask_pd(m) << (k * 4);
+        }
+        out[w] = bits;
+    }
+    if (n % 64 != 0) compareScalar(x + full * 64, n % 64, op, v, out + full);
+}
+
+// 32 uint8 per vector; unsigned order via the sign-flip trick
+AVX2_TARGET static void compareU8Avx2(const uint8_t* x, size_t n, CompareOp op, uint8_t v, uint64_t* out) {
+    __m256i flip = _mm256_set1_epi8((char)0x80);
+    __m256i value = _mm256_set1_epi8((char)(v ^ 0x80));
+    size_t full = n / 64;
+    for (size_t w = 0; w < full; w++) {
+        uint64_t bits = 0;
+        for (int k = 0; k < 2; k++) {
+            __m256i a = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(x + w * 64 + k * 32)), flip);
+            __m256i m;
+            if (op == CompareOp::Greater) m = _mm256_cmpgt_epi8(a, value);
+            else if (op == CompareOp::Less) m = _mm256_cmpgt_epi8(value, a);
+            else m = _mm256_cmpeq_epi8(a, value);
+            bits |= (uint64_t)(uint32_t)_mm256_movemask_epi8(m) << (k * 32);
+        }
+        out[w] = op == CompareOp::NotEqual ? ~bits : bits;
+    }
+    if (n % 64 != 0) compareScalar(x + full * 64, n % 64, op, v, out + full);
+}
+
+#endif
+
+// ---------------------------------------------------------------- Column dispatch
+
+static const int32_t* intColumn(const StudentTable& t, StudentColumn c) {
+    switch (c) {
+    case StudentColumn::IQ:                   return t.iq.data();
+    case StudentColumn::AcademicPerformance:  return t.academic_performance.data();
+    case StudentColumn::ExtraCurricularScore: return t.extra_curricular_score.data();
+    case StudentColumn::CommunicationSkills:  return t.communication_skills.data();
+    case StudentColumn::ProjectsCompleted:    return t.projects_completed.data();
+    default:                                  return nullptr;
+    }
+}
+
+static const double* doubleColumn(const StudentTable& t, StudentColumn c) {
+    if (c == StudentColumn::PrevSemResult) return t.prev_sem_result.data();
+    if (c == StudentColumn::CGPA) return t.cgpa.data();
+    return nullptr;
+}
+
+static const uint8_t* flagColumn(const StudentTable& t, StudentColumn c) {
+    if (c == StudentColumn::InternshipExperience) return t.internship_experience.data();
+    if (c == StudentColumn::Placement) return t.placement.data();
+    return nullptr;
+}
+
+Selection scanPredicate(const StudentTable& table, const Predicate& predicate) {
+    size_t n = table.size();
+    Selection result(n, false);
+    uint64_t* out = result.words.data();
+
+    if (const double* d = doubleColumn(table, predicate.column)) {
+#ifdef STUDENT_FILTER_X86
+        if (cpuFeatures().avx2) {
+            compareF64Avx2(d, n, predicate.op, predicate.value, out);
+            return result;
+        }
+#endif
+        compareScalar(d, n, predicate.op, predicate.value, out);
+        return result;
+    }
+
+    const int32_t* i32 = intColumn(table, predicate.column);
+    long long lo = i32 ? INT32_MIN : 0, hi = i32 ? INT32_MAX : 255;
+    CompareOp op = predicate.op;
+    long long v = 0;
+    int constant = normalizeInteger(predicate.op, predicate.value, lo, hi, op, v);
+    if (constant >= 0) return Selection(n, constant == 1);
+
+    if (i32) {
+#ifdef STUDENT_FILTER_X86
+        if (cpuFeatures().avx2) {
+            compareI32Avx2(i32, n, op, (int32_t)v, out);
+            return result;
+        }
+#endif
+        compareScalar(i32, n, op, (int32_t)v, out);
+    } else {
+        const uint8_t* u8 = flagColumn(table, predicate.column);
+#ifdef STUDENT_FILTER_X86
+        if (cpuFeatures().avx2) {
+            compareU8Avx2(u8, n, op, (uint8_t)v, out);
+            return result;
+        }
+#endif
+        compareScalar(u8, n, op, (uint8_t)v, out);
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------- Bitmap index
+
+void StudentIndex::build(const StudentTable& table) {
+    rows = table.size();
+    for (int c = 0; c < StudentColumnCount; c++) {
+        StudentColumn column = (StudentColumn)c;
+        indexed[c] = false;
+        bitmaps[c].clear();
+        const int32_t* i32 = intColumn(table, column);
+        const uint8_t* u8 = flagColumn(table, column);
+        if ((!i32 && !u8) || rows == 0) continue; // Doubles are never low-cardinality here
+
+        int lo = i32 ? *std::min_element(i32, i32 + rows) : *std::min_element(u8, u8 + rows);
+        int hi = i32 ? *std::max_element(i32, i32 + rows) : *std::max_element(u8, u8 + rows);
+        if ((long long)hi - lo >= MaxValues) continue; // Too many values for per-value bitmaps
+
+        indexed[c] = true;
+        minValue[c] = lo;
+        bitmaps[c].assign(hi - lo + 1, Selection(rows, false));
+        for (size_t r = 0; r < rows; r++) {
+            int value = i32 ? i32[r] : u8[r];
+            bitmaps[c][value - lo].words[r / 64] |= 1ull << (r % 64);
+        }
+    }
+}
+
+bool StudentIndex::covers(StudentColumn column) const {
+    return indexed[(int)column];
+}
+
+size_t StudentIndex::size() const {
+    return rows;
+}
+
+Selection StudentIndex::evaluate(const Predicate& predicate) const {
+    int c = (int)predicate.column;
+    Selection result(rows, false);
+    for (size_t k = 0; k < bitmaps[c].size(); k++) {
+        int value = minValue[c] + (int)k;
+        if (holds((double)value, predicate.op, predicate.value)) result.orWith(bitmaps[c][k]);
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------- Query
+
+StudentQuery& StudentQuery::where(const Predicate& predicate) {
+    if (anyOf.empty()) anyOf.emplace_back();
+    anyOf.back().push_back(predicate);
+    return *this;
+}
+
+StudentQuery& StudentQuery::orElse() {
+    anyOf.emplace_back();
+    return *this;
+}
+
+Selection StudentQuery::run(const StudentTable& table, const StudentIndex* index) const {
+    size_t n = table.size();
+    if (anyOf.empty()) return Selection(n, true);
+    bool useIndex = index && index->size() == n;
+    Selection result(n, false);
+    for (const std::vector<Predicate>& group : anyOf) {
+        Selection matched(n, true);
+        for (const Predicate& p : group) {
+            if (useIndex && index->covers(p.column)) matched.andWith(index->evaluate(p));
+            else matched.andWith(scanPredicate(table, p));
+        }
+        result.orWith(matched);
+    }
+    return result;
+}
+
+static const char* const columnNames[StudentColumnCount] = {
+    "iq", "prev_sem_result", "cgpa", "academic_performance", "internship_experience",
+    "extra_curricular_score", "communication_skills", "projects_completed", "placement"
+};
+
+bool studentColumnByName(const std::string& name, StudentColumn& column) {
+    std::string lower = name;
+    for (char& ch : lower) ch = (char)std::tolower((unsigned char)ch); // Also accepts CSV header spelling
+    for (int c = 0; c < StudentColumnCount; c++) {
+        if (lower == columnNames[c]) {
+            column = (StudentColumn)c;
+            return true;
+        }
+    }
+    if (lower == "internship") { column = StudentColumn::InternshipExperience; return true; }
+    if (lower == "placed") { column = StudentColumn::Placement; return true; }
+    return false;
+}
+
+const char* studentColumnName(StudentColumn column) {
+    return columnNames[(int)column];
+}
+
+bool StudentQuery::parse(const std::string& text, StudentQuery& query, std::string& error) {
+    query = StudentQuery();
+    size_t i = 0;
+    auto skipSpaces = [&]() { while (i < text.size() && std::isspace((unsigned char)text[i])) i++; };
+    auto word = [&]() {
+        size_t start = i;
+        while (i < text.size() && (std::isalnum((unsigned char)text[i]) || text[i] == '_')) i++;
+        return text.substr(start, i - start);
+    };
+
+    while (true) {
+        skipSpaces();
+        bool negate = false;
+        if (i < text.size() && text[i] == '!') { negate = true; i++; skipSpaces(); }
+        std::string name = word();
+        StudentColumn column;
+        if (name.empty() || !studentColumnByName(name, column)) {
+            error = "Unknown column '" + name + "' at position " + std::to_string(i);
+            return false;
+        }
+
+        skipSpaces();
+        Predicate p = {column, CompareOp::NotEqual, 0};  // Bare column: true when non-zero / Yes
+        static const char* const ops[] = {"<=", ">=", "==", "!=", "<", ">", "="};
+        static const CompareOp opValues[] = {CompareOp::LessEqual, CompareOp::GreaterEqual, CompareOp::Equal,
+                                             CompareOp::NotEqual, CompareOp::Less, CompareOp::Greater,
+                                             CompareOp::Equal};
+        bool hasOp = false;
+        for (int k = 0; k < 7; k++) {
+            size_t len = std::char_traits<char>::length(ops[k]);
+            if (text.compare(i, len, ops[k]) == 0) {
+                p.op = opValues[k];
+                i += len;
+                hasOp = true;
+                break;
+            }
+        }
+        if (hasOp) {
+            if (negate) { error = "'!' only applies to a bare column"; return false; }
+            skipSpaces();
+            size_t start = i;
+            std::string literal = word();
+            if (literal == "Yes" || literal == "yes" || literal == "true") p.value = 1;
+            else if (literal == "No" || literal == "no" || literal == "false") p.value = 0;
+            else {
+                i = start;
+                char* end = nullptr;
+                p.value = std::strtod(text.c_str() + i, &end);
+                if (end == text.c_str() + i || std::isnan(p.value)) {
+                    error = "Expected a value at position " + std::to_string(i);
+                    return false;
+                }
+                i = (size_t)(end - text.c_str());
+            }
+        } else if (negate) {
+            p.op = CompareOp::Equal;  // !column: zero / No
+        }
+        query.where(p);
+
+        skipSpaces();
+        if (i >= text.size()) return true;
+        if (text.compare(i, 2, "&&") == 0) { i += 2; continue; }
+        if (text.compare(i, 2, "||") == 0) { i += 2; query.orElse(); continue; }
+        error = "Expected && or || at position " + std::to_string(i);
+        return false;
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "studenttable.h"
+
+/*
+This header file defines the filter API over StudentTable columns.
+A query such as
+    cgpa > 8.0 && internship_experience && communication_skills >= 7
+is parsed into predicates that run as SIMD comparison kernels (AVX2 when
+the CPU has it, a portable loop otherwise) over whole columns, each one
+producing a selection bitmap with one bit per row. Low-cardinality
+columns (Yes/No fields and the 0-10 scores) can also be answered from a
+StudentIndex of precomputed per-value bitmaps, which turns a predicate
+into a few word-wide ORs.
+*/
+
+enum class StudentColumn {
+    IQ, PrevSemResult, CGPA, AcademicPerformance, InternshipExperience,
+    ExtraCurricularScore, CommunicationSkills, ProjectsCompleted, Placement
+};
+const int StudentColumnCount = 9;
+
+enum class CompareOp { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual };
+
+// One bit per row; bit i of words[i / 64] is set when row i is selected
+class Selection {
+public:
+    std::vector<uint64_t> words;
+    size_t rows = 0;
+
+    Selection() = default;
+    Selection(size_t rowCount, bool selected); // All rows selected or none
+
+    size_t count() const;                      // Number of selected rows
+    bool test(size_t row) const;               // True if the row is selected
+    void andWith(const Selection& other);      // Keeps rows selected in both
+    void orWith(const Selection& other);       // Adds rows selected in other
+    std::vector<uint32_t> toRows() const;      // Row numbers of the selected rows, ascending
+};
+
+struct Predicate {
+    StudentColumn column;
+    CompareOp op;
+    double value;  // Yes/No columns use 1 for Yes and 0 for No
+};
+
+// Precomputed per-value bitmaps for columns with at most MaxValues distinct small integers
+class StudentIndex {
+private:
+    static const int MaxValues = 16;
+    bool indexed[StudentColumnCount] = {};       // Column has per-value bitmaps
+    int minValue[StudentColumnCount] = {};       // Value stored in bitmaps[column][0]
+    std::vector<Selection> bitmaps[StudentColumnCount];
+    size_t rows = 0;
+
+public:
+    void build(const StudentTable& table);       // Indexes every low-cardinality column
+    bool covers(StudentColumn column) const;     // True if predicates on the column can use the index
+    Selection evaluate(const Predicate& predicate) const; // ORs the bitmaps of the matching values
+    size_t size() const;                         // Rows covered by the index
+};
+
+class StudentQuery {
+private:
+    std::vector<std::vector<Predicate>> anyOf;   // OR of AND-groups
+
+public:
+    StudentQuery& where(const Predicate& predicate); // ANDs a predicate onto the current group
+    StudentQuery& orElse();                      // Starts a new OR group
+
+    // Parses "a > 1 && b || c == Yes"; && binds tighter than ||. False with a message on error.
+    static bool parse(const std::string& text, StudentQuery& query, std::string& error);
+
+    // Evaluates the query; index may be null (or stale) to force column scans
+    Selection run(const StudentTable& table, const StudentIndex* index = nullptr) const;
+};
+
+// Runs one predicate over a column with the fastest available kernel
+Selection scanPredicate(const StudentTable& table, const Predicate& predicate);
+
+bool studentColumnByName(const std::string& name, StudentColumn& column); // Maps "cgpa" etc. to a column
+const char* studentColumnName(StudentColumn column);                      // Inverse of the above
@@ -0,0 +1,235 @@
+#include "studentfollow.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include "../common/mappedfile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+/*
+This source file implements the incremental aggregates and the
+StudentFollower declared in studentfollow.h.
+*/
+
+// ---------------------------------------------------------------- PlacementSummary
+
+void PlacementSummary::reset() {
+    *this = PlacementSummary();
+}
+
+void PlacementSummary::update(const StudentTable& table, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        placed += table.placement[i];
+        internships += table.internship_experience[i];
+        cgpaSum += table.cgpa[i];
+        iqSum += table.iq[i];
+        projectsSum += table.projects_completed[i];
+    }
+    count += end - begin;
+}
+
+double PlacementSummary::placementRate() const {
+    return count ? (double)placed / count : 0;
+}
+
+double PlacementSummary::meanCgpa() const {
+    return count ? cgpaSum / count : 0;
+}
+
+double PlacementSummary::meanIq() const {
+    return count ? iqSum / count : 0;
+}
+
+double PlacementSummary::meanProjects() const {
+    return count ? projectsSum / count : 0;
+}
+
+// ---------------------------------------------------------------- StudentFollower
+
+const int PollIntervalMs = 100; // Size checks while waiting without inotify
+
+// Device and inode of the file at path (volume serial and file index on Windows); false if it is missing
+static bool fileIdentity(const std::string& path, uint64_t& device, uint64_t& inode) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    BY_HANDLE_FILE_INFORMATION info;
+    bool ok = GetFileInformationByHandle(file, &info) != 0;
+    CloseHandle(file);
+    device = ok ? info.dwVolumeSerialNumber : 0;
+    inode = ok ? ((uint64_t)info.nFileIndexHigh << 32) | info.nFileIndexLow : 0;
+    return ok;
+#else
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) return false;
+    device = (uint64_t)info.st_dev;
+    inode = (uint64_t)info.st_ino;
+    return true;
+#endif
+}
+
+StudentFollower::StudentFollower(const std::string& path) : path(path) {
+#ifdef __linux__
+    watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+StudentFollower::~StudentFollower() {
+#ifdef __linux__
+    if (watchFd >= 0) ::close(watchFd);
+#endif
+}
+
+void StudentFollower::addAggregate(StudentAggregate& aggregate) {
+    aggregates.push_back(&aggregate);
+}
+
+void StudentFollower::watch() {
+#ifdef __linux__
+    if (watchFd < 0) return;
+    if (watchId >= 0) inotify_rm_watch(watchFd, watchId);
+    watchId = inotify_add_watch(watchFd, path.c_str(),
+                                IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVE_SELF | IN_DELETE_SELF);
+#endif
+}
+
+void StudentFollower::restart() {
+    table->clear();
+    for (StudentAggregate* aggregate : aggregates) aggregate->reset();
+    offset = 0;
+    headerSeen = false;
+    resets++;
+}
+
+size_t StudentFollower::consume(const char* begin, const char* end) {
+    // Only whole lines: stop after the last newline
+    const char* stop = end;
+    while (stop > begin && stop[-1] != '\n') stop--;
+    if (stop == begin) return 0;
+
+    const char* p = begin;
+    if (!headerSeen) {
+        p = (const char*)std::memchr(p, '\n', (size_t)(stop - p)) + 1;
+        headerSeen = true;
+    }
+
+    size_t first = table->size();
+    badRows += parseStudentRows(p, stop, *table, threads);
+    if (table->size() > first) {
+        for (StudentAggregate* aggregate : aggregates) aggregate->update(*table, first, table->size());
+    }
+    return (size_t)(stop - begin);
+}
+
+bool StudentFollower::open(StudentTable& target, int threads) {
+    table = &target;
+    this->threads = threads;
+    table->clear();
+    for (StudentAggregate* aggregate : aggregates) aggregate->reset();
+    offset = 0;
+    headerSeen = false;
+    badRows = 0;
+    resets = 0;
+
+    // The existing contents can be large: map them and parse in parallel
+    MappedFile file;
+    if (!file.open(path)) return false;
+    fileIdentity(path, fileDevice, fileInode);
+    fileSize = file.size();
+    offset = consume(file.data(), file.data() + file.size());
+    file.close();
+
+    watch();
+    return true;
+}
+
+size_t StudentFollower::poll() {
+    if (!table) return 0;
+    // A rotated or replaced file can be as long as the old one or longer, so the size alone
+    // cannot tell; checked before opening, so a replacement after that is caught next time
+    uint64_t device = 0, inode = 0;
+    if (fileIdentity(path, device, inode) && (device != fileDevice || inode != fileInode)) {
+        restart();
+        fileDevice = device;
+        fileInode = inode;
+    }
+    std::ifstream in(path, std::ios::binary); // Reopened each time so a replaced file is noticed
+    if (!in) return 0;
+    in.seekg(0, std::ios::end);
+    std::streamoff size = in.tellg();
+    if (size < 0) return 0;
+    fileSize = (uint64_t)size;
+
+    if (fileSize < offset) restart(); // Truncated or replaced by a shorter file
+    if (fileSize == offset) return 0;
+
+    // Read only what lies past the consumed offset
+    buffer.resize((size_t)(fileSize - offset));
+    in.seekg((std::streamoff)offset);
+    in.read(buffer.data(), (std::streamsize)buffer.size());
+    buffer.resize((size_t)in.gcount());
+
+    size_t before = table->size();
+    offset += consume(buffer.data(), buffer.data() + buffer.size());
+    return table->size() - before;
+}
+
+size_t StudentFollower::wait(int timeoutMs) {
+#ifdef __linux__
+    if (watchFd >= 0 && watchId < 0) watch(); // The file may have been recreated since
+    if (watchFd >= 0 && watchId >= 0) {
+        pollfd pfd = {watchFd, POLLIN, 0};
+        if (::poll(&pfd, 1, timeoutMs) > 0) {
+            // Drain every queued event; one poll() below covers them all
+            alignas(inotify_event) char events[4096];
+            bool moved = false;
+            ssize_t n;
+            while ((n = ::read(watchFd, events, sizeof(events))) > 0) {
+                for (ssize_t i = 0; i < n;) {
+                    const inotify_event* event = (const inotify_event*)(events + i);
+                    if (event->wd == watchId && (event->mask & (IN_MOVE_SELF | IN_DELETE_SELF | IN_IGNORED))) {
+                        moved = true;
+                    }
+                    i += sizeof(inotify_event) + event->len;
+                }
+            }
+            if (moved) watch(); // Follow the path, not the old file
+        }
+        return poll();
+    }
+#endif
+    // No inotify: check the size every PollIntervalMs until something arrives or time runs out
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (true) {
+        size_t rows = poll();
+        if (rows > 0 || std::chrono::steady_clock::now() >= deadline) return rows;
+        std::this_thread::sleep_for(std::chrono::milliseconds(PollIntervalMs));
+    }
+}
+
+uint64_t StudentFollower::consumedOffset() const {
+    return offset;
+}
+
+size_t StudentFollower::pendingBytes() const {
+    return (size_t)(fileSize > offset ? fileSize - offset : 0);
+}
+
+size_t StudentFollower::badRowCount() const {
+    return badRows;
+}
+
+size_t StudentFollower::resetCount() const {
+    return resets;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "studenttable.h"
+
+/*
+This header file defines follow mode for a placement CSV that keeps
+growing while it is read (like tail -f).
+
+StudentFollower loads the file once, remembers the byte offset just
+past the last complete line and afterwards reads only the bytes appended
+beyond it. A last line without its newline is left unconsumed and is
+read again once the rest has arrived. On Linux the follower sleeps on
+inotify until the file changes; elsewhere it checks the file size on a
+short interval.
+
+Aggregates registered with the follower are told about every batch of
+new rows, so counts and running means stay current without rescanning
+old data. If the file shrinks (truncated) or the path names a different
+file (replaced or rotated: another device and inode), the table and
+every aggregate are reset and reading starts over from the top.
+*/
+
+// Incrementally maintained result over the rows of a followed table
+class StudentAggregate {
+public:
+    virtual ~StudentAggregate() = default;
+    virtual void reset() = 0;                                                 // Forget every row
+    virtual void update(const StudentTable& table, size_t begin, size_t end) = 0; // Rows [begin, end) are new
+};
+
+// Row count, placement rate and running means of the numeric columns
+class PlacementSummary : public StudentAggregate {
+public:
+    size_t count = 0;
+    size_t placed = 0;
+    size_t internships = 0;
+    double cgpaSum = 0;
+    double iqSum = 0;
+    double projectsSum = 0;
+
+    void reset() override;
+    void update(const StudentTable& table, size_t begin, size_t end) override;
+
+    double placementRate() const; // Fraction of students placed (0 with no rows)
+    double meanCgpa() const;
+    double meanIq() const;
+    double meanProjects() const;
+};
+
+class StudentFollower {
+private:
+    std::string path;
+    StudentTable* table = nullptr;
+    std::vector<StudentAggregate*> aggregates;
+    uint64_t offset = 0;          // File position just past the last complete line consumed
+    uint64_t fileSize = 0;        // Size of the file at the last poll
+    uint64_t fileDevice = 0;      // Device and inode of the file being read, to notice a replacement
+    uint64_t fileInode = 0;
+    bool headerSeen = false;      // False until the header line has been skipped
+    int threads = 0;              // Parser threads for large batches
+    std::vector<char> buffer;     // Bytes read past offset; an incomplete last line is read again next time
+    size_t badRows = 0;
+    size_t resets = 0;
+    int watchFd = -1;             // inotify descriptor (Linux only)
+    int watchId = -1;             // inotify watch on the file
+
+    size_t consume(const char* begin, const char* end);             // Parses complete lines; returns bytes used
+    void restart();                                                  // Clears everything after truncation or replacement
+    void watch();                                                    // (Re)arms the inotify watch
+
+public:
+    explicit StudentFollower(const std::string& path);
+    ~StudentFollower();
+    StudentFollower(const StudentFollower&) = delete;
+    StudentFollower& operator=(const StudentFollower&) = delete;
+
+    void addAggregate(StudentAggregate& aggregate); // Not owned; must outlive the follower
+
+    // Loads the complete lines already in the file into table (cleared first) and feeds the
+    // aggregates. False if the file cannot be opened.
+    bool open(StudentTable& table, int threads = 0);
+
+    // Reads whatever was appended since the last call and returns the number of new rows.
+    // Never blocks.
+    size_t poll();
+
+    // Blocks until the file may have changed or timeoutMs passes, then polls.
+    size_t wait(int timeoutMs);
+
+    uint64_t consumedOffset() const;  // Bytes of the file consumed as complete lines
+    size_t pendingBytes() const;      // Bytes of an incomplete last line held back
+    size_t badRowCount() const;       // Malformed rows skipped so far
+    size_t resetCount() const;        // Times the file shrank or was replaced and was read again from the top
+};
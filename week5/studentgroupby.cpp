@@ -0,0 +1,319 @@
+#include "studentgroupby.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <unordered_map>
+#include "../common/cpu.h"
+
+/*
+This source file implements the group-by engine declared in
+studentgroupby.h. Rows are processed in blocks: the key columns of a
+block are turned into one composite group code per row, the value
+column is widened to double, and then each row is added to its group's
+running totals. Thread partials are merged with Chan's parallel
+variance formula.
+*/
+
+namespace {
+
+const size_t BlockRows = 1024;
+const size_t ParallelRows = 16384;  // Fewer rows per thread group on one thread
+const double BandTolerance = 1e-9;  // Relative; far above division error, far below any real band width
+
+// Per-thread running totals of (x - shift), where shift is the middle of the value
+// column's range: the shifted-data variance algorithm, with no divisions or branches
+// in the hot loop.
+struct Accumulator {
+    size_t count = 0;
+    double sum = 0;
+    double sumSq = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void add(double d) {
+        count++;
+        sum += d;
+        sumSq += d * d;
+        min = d < min ? d : min;
+        max = d > max ? d : max;
+    }
+};
+
+// Count, mean and squared deviations of one group; partials combine with Chan's formula
+struct Moments {
+    size_t count = 0;
+    double sum = 0;
+    double mean = 0;
+    double m2 = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void merge(const Accumulator& acc, double shift) {
+        if (acc.count == 0) return;
+        double n = (double)acc.count;
+        double accMean = shift + acc.sum / n;
+        double accM2 = std::max(0.0, acc.sumSq - acc.sum * acc.sum / n);
+        sum += shift * n + acc.sum;
+        if (count == 0) {
+            count = acc.count;
+            mean = accMean;
+            m2 = accM2;
+        } else {
+            double total = (double)(count + acc.count);
+            double delta = accMean - mean;
+            mean += delta * n / total;
+            m2 += accM2 + delta * delta * (double)count * n / total;
+            count += acc.count;
+        }
+        min = std::min(min, acc.min + shift);
+        max = std::max(max, acc.max + shift);
+    }
+};
+
+// How the key columns map to one composite code: code = sum((band_k - lowBand_k) * stride_k)
+struct KeyLayout {
+    size_t keyCount = 0;
+    long long lowBand[MaxGroupKeys] = {};
+    long long stride[MaxGroupKeys] = {};
+    double space = 0;  // Number of possible codes
+    double shift = 0;  // Subtracted from every value before it is accumulated
+};
+
+}
+
+// Copies column values for rows [begin, end) into out as doubles
+static void readColumn(const StudentTable& t, StudentColumn column, size_t begin, size_t end, double* out) {
+    size_t n = end - begin;
+    switch (column) {
+    case StudentColumn::IQ:                   for (size_t i = 0; i < n; i++) out[i] = t.iq[begin + i]; break;
+    case StudentColumn::PrevSemResult:        for (size_t i = 0; i < n; i++) out[i] = t.prev_sem_result[begin + i]; break;
+    case StudentColumn::CGPA:                 for (size_t i = 0; i < n; i++) out[i] = t.cgpa[begin + i]; break;
+    case StudentColumn::AcademicPerformance:  for (size_t i = 0; i < n; i++) out[i] = t.academic_performance[begin + i]; break;
+    case StudentColumn::InternshipExperience: for (size_t i = 0; i < n; i++) out[i] = t.internship_experience[begin + i]; break;
+    case StudentColumn::ExtraCurricularScore: for (size_t i = 0; i < n; i++) out[i] = t.extra_curricular_score[begin + i]; break;
+    case StudentColumn::CommunicationSkills:  for (size_t i = 0; i < n; i++) out[i] = t.communication_skills[begin + i]; break;
+    case StudentColumn::ProjectsCompleted:    for (size_t i = 0; i < n; i++) out[i] = t.projects_completed[begin + i]; break;
+    case StudentColumn::Placement:            for (size_t i = 0; i < n; i++) out[i] = t.placement[begin + i]; break;
+    }
+}
+
+// Turns raw key values into band numbers; rows with non-finite values are flagged invalid.
+// Floors by truncating and correcting, which avoids a libm call per row. A decimal width is not exact
+// in binary (5.6 / 0.1 is 55.999...), so quotients are nudged up by a relative BandTolerance first.
+static void toBands(const double* values, size_t n, double width, long long* bands, uint8_t* valid) {
+    for (size_t i = 0; i < n; i++) {
+        double q = width == 1 ? values[i] : values[i] / width;
+        q += std::fabs(q) * BandTolerance;
+        bool ok = std::fabs(q) < 1e15;  // False for NaN and infinity too
+        long long t = ok ? (long long)q : 0;
+        bands[i] = t - (long long)(q < (double)t);
+        valid[i] &= (uint8_t)ok;
+    }
+}
+
+// Smallest and largest finite value of a column over rows [begin, end)
+template <typename T>
+static void rangeOf(const Column<T>& column, size_t begin, size_t end, double& lo, double& hi) {
+    T low = std::numeric_limits<T>::max(), high = std::numeric_limits<T>::lowest();
+    for (size_t i = begin; i < end; i++) {
+        T x = column[i];
+        if (std::numeric_limits<T>::has_infinity && !(std::fabs((double)x) < std::numeric_limits<T>::infinity())) {
+            continue;  // NaN or infinite doubles do not get a group
+        }
+        low = x < low ? x : low;
+        high = x > high ? x : high;
+    }
+    lo = (double)low;
+    hi = (double)high;
+}
+
+static void columnRange(const StudentTable& t, StudentColumn column, size_t begin, size_t end, double& lo, double& hi) {
+    switch (column) {
+    case StudentColumn::IQ:                   rangeOf(t.iq, begin, end, lo, hi); break;
+    case StudentColumn::PrevSemResult:        rangeOf(t.prev_sem_result, begin, end, lo, hi); break;
+    case StudentColumn::CGPA:                 rangeOf(t.cgpa, begin, end, lo, hi); break;
+    case StudentColumn::AcademicPerformance:  rangeOf(t.academic_performance, begin, end, lo, hi); break;
+    case StudentColumn::InternshipExperience: rangeOf(t.internship_experience, begin, end, lo, hi); break;
+    case StudentColumn::ExtraCurricularScore: rangeOf(t.extra_curricular_score, begin, end, lo, hi); break;
+    case StudentColumn::CommunicationSkills:  rangeOf(t.communication_skills, begin, end, lo, hi); break;
+    case StudentColumn::ProjectsCompleted:    rangeOf(t.projects_completed, begin, end, lo, hi); break;
+    case StudentColumn::Placement:            rangeOf(t.placement, begin, end, lo, hi); break;
+    }
+    if (begin == end) {
+        lo = std::numeric_limits<double>::infinity();  // Empty slice: contributes nothing
+        hi = -lo;
+    }
+}
+
+// Fills codes/values/valid for one block; returns false if the block has no selected rows
+static bool prepareBlock(const StudentTable& table, const std::vector<GroupKey>& keys, StudentColumn value,
+                         const KeyLayout& layout, const Selection* filter, size_t begin, size_t end,
+                         long long* codes, double* values, uint8_t* valid) {
+    size_t n = end - begin;
+    bool any = false;
+    for (size_t i = 0; i < n; i++) {
+        valid[i] = filter ? (uint8_t)filter->test(begin + i) : 1;
+        any |= valid[i] != 0;
+    }
+    if (!any) return false;
+
+    double raw[BlockRows];
+    long long bands[BlockRows];
+    std::fill(codes, codes + n, 0);
+    for (size_t k = 0; k < layout.keyCount; k++) {
+        readColumn(table, keys[k].column, begin, end, raw);
+        toBands(raw, n, keys[k].width, bands, valid);
+        for (size_t i = 0; i < n; i++) codes[i] += (bands[i] - layout.lowBand[k]) * layout.stride[k];
+    }
+    readColumn(table, value, begin, end, values);
+    for (size_t i = 0; i < n; i++) {
+        valid[i] &= (uint8_t)!std::isnan(values[i]);
+        values[i] -= layout.shift;
+    }
+    return true;
+}
+
+double GroupResult::variance() const {
+    return count > 1 ? m2 / (double)(count - 1) : 0;
+}
+
+bool groupStudents(const StudentTable& table, const std::vector<GroupKey>& keys, StudentColumn value,
+                   std::vector<GroupResult>& out, const GroupByOptions& options) {
+    out.clear();
+    if (keys.empty() || keys.size() > (size_t)MaxGroupKeys) return false;
+    for (const GroupKey& key : keys) {
+        if (!(key.width > 0) || !std::isfinite(key.width)) return false;
+    }
+    size_t rows = table.size();
+    if (options.filter && options.filter->rows != rows) return false;
+    if (rows == 0) return true;
+
+    int threads = sliceCount(rows, options.threads, ParallelRows);
+
+    // Pass 1: value range of every key column. Banding is monotonic, so the band range
+    // (and with it the code space) follows from each column's min and max.
+    // The value column's range gives the shift.
+    size_t columns = keys.size() + 1;
+    std::vector<double> lows((size_t)threads * columns), highs((size_t)threads * columns);
+    runSlices(rows, threads, [&](int slice, size_t begin, size_t end) {
+        for (size_t k = 0; k < columns; k++) {
+            columnRange(table, k < keys.size() ? keys[k].column : value, begin, end, lows[slice * columns + k],
+                        highs[slice * columns + k]);
+        }
+    });
+
+    KeyLayout layout;
+    layout.keyCount = keys.size();
+    layout.space = 1;
+    for (size_t k = columns; k-- > 0;) {
+        double lo = std::numeric_limits<double>::infinity(), hi = -lo;
+        for (int t = 0; t < threads; t++) {
+            lo = std::min(lo, lows[t * columns + k]);
+            hi = std::max(hi, highs[t * columns + k]);
+        }
+        if (lo > hi) return true;  // Every key (or value) was NaN or infinite
+        if (k == keys.size()) {
+            layout.shift = lo + (hi - lo) / 2;
+            continue;
+        }
+        double ends[2] = {lo, hi};
+        long long bands[2];
+        uint8_t valid[2] = {1, 1};
+        toBands(ends, 2, keys[k].width, bands, valid);
+        if (!valid[0] || !valid[1]) return false;  // Keys too large to band
+        layout.lowBand[k] = bands[0];
+        layout.stride[k] = (long long)layout.space;
+        layout.space *= (double)(bands[1] - bands[0] + 1);
+        if (layout.space > 4e18) return false; // Codes would not fit in 64 bits
+    }
+    bool dense = layout.space <= (double)options.denseLimit;
+
+    // Pass 2: per-thread partial aggregates
+    std::vector<std::vector<Accumulator>> denseParts(dense ? threads : 0);
+    std::vector<std::unordered_map<long long, Accumulator>> hashParts(dense ? 0 : threads);
+    runSlices(rows, threads, [&](int slice, size_t begin, size_t end) {
+        long long codes[BlockRows];
+        double values[BlockRows];
+        uint8_t valid[BlockRows];
+        if (dense) denseParts[slice].resize((size_t)layout.space);
+        for (size_t b = begin; b < end; b += BlockRows) {
+            size_t e = std::min(end, b + BlockRows);
+            if (!prepareBlock(table, keys, value, layout, options.filter, b, e, codes, values, valid)) continue;
+            if (dense) {
+                Accumulator* groups = denseParts[slice].data();
+                for (size_t i = 0; i < e - b; i++) {
+                    if (valid[i]) groups[codes[i]].add(values[i]);
+                }
+            } else {
+                std::unordered_map<long long, Accumulator>& groups = hashParts[slice];
+                for (size_t i = 0; i < e - b; i++) {
+                    if (valid[i]) groups[codes[i]].add(values[i]);
+                }
+            }
+        }
+    });
+
+    // Merge the partials and list groups in code (= key) order
+    std::vector<std::pair<long long, Moments>> merged;
+    if (dense) {
+        for (size_t c = 0; c < (size_t)layout.space; c++) {
+            Moments moments;
+            for (int t = 0; t < threads; t++) moments.merge(denseParts[t][c], layout.shift);
+            if (moments.count > 0) merged.emplace_back((long long)c, moments);
+        }
+    } else {
+        std::unordered_map<long long, Moments> all;
+        for (int t = 0; t < threads; t++) {
+            for (const auto& entry : hashParts[t]) all[entry.first].merge(entry.second, layout.shift);
+        }
+        merged.assign(all.begin(), all.end());
+        std::sort(merged.begin(), merged.end(),
+                  [](const std::pair<long long, Moments>& a, const std::pair<long long, Moments>& b) {
+                      return a.first < b.first;
+                  });
+    }
+
+    out.reserve(merged.size());
+    for (const auto& entry : merged) {
+        GroupResult group;
+        long long code = entry.first;
+        for (size_t k = 0; k < keys.size(); k++) {
+            long long band = code / layout.stride[k] + layout.lowBand[k];
+            code %= layout.stride[k];
+            group.key[k] = (double)band * keys[k].width;
+        }
+        const Moments& m = entry.second;
+        group.count = m.count;
+        group.mean = m.mean;
+        group.sum = m.sum;
+        group.min = m.min;
+        group.max = m.max;
+        group.m2 = m.m2;
+        out.push_back(group);
+    }
+    return true;
+}
+
+bool parseGroupKeys(const std::string& text, std::vector<GroupKey>& keys) {
+    keys.clear();
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t comma = text.find(',', start);
+        if (comma == std::string::npos) comma = text.size();
+        std::string part = text.substr(start, comma - start);
+        size_t colon = part.find(':');
+
+        GroupKey key;
+        if (!studentColumnByName(part.substr(0, colon), key.column)) return false;
+        if (colon != std::string::npos) {
+            char* end = nullptr;
+            key.width = std::strtod(part.c_str() + colon + 1, &end);
+            if (*end != '\0' || !(key.width > 0)) return false;
+        }
+        keys.push_back(key);
+        start = comma + 1;
+    }
+    return !keys.empty() && keys.size() <= (size_t)MaxGroupKeys;
+}
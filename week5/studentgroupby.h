@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "studentfilter.h"
+#include "studenttable.h"
+
+/*
+This header file defines the group-by engine for StudentTable. Rows are
+grouped by one or more key columns, each optionally cut into bands
+(iq in bands of 10, cgpa in bands of 0.5), and one value column is
+aggregated per group: count, sum, mean, min, max and variance. The mean
+of a Yes/No column is a rate, so "placement by iq:10" is the placement
+rate per IQ band.
+
+Each thread aggregates its own slice of rows into private partials which
+are merged at the end. When every key combination fits in a small range
+the partials are plain arrays indexed by key, otherwise hash maps.
+*/
+
+const int MaxGroupKeys = 3;
+
+struct GroupKey {
+    StudentColumn column;
+    double width = 1;      // Band width; rows with width * k <= value < width * (k + 1) share a group
+};
+
+struct GroupResult {
+    double key[MaxGroupKeys] = {}; // Lower bound of each key's band, in GroupKey order
+    size_t count = 0;
+    double sum = 0;
+    double mean = 0;
+    double min = 0;
+    double max = 0;
+    double m2 = 0;         // Sum of squared differences from the mean
+
+    double variance() const; // Sample variance (0 for a single row)
+};
+
+struct GroupByOptions {
+    const Selection* filter = nullptr; // Only selected rows are aggregated when set
+    int threads = 0;                   // 0 uses every hardware thread
+    size_t denseLimit = 4096;          // Largest key space aggregated in arrays instead of hash maps
+};
+
+// Groups table rows by keys and aggregates value, sorted by key.
+// Returns false (and leaves out empty) for bad keys, such as a non-positive band width.
+bool groupStudents(const StudentTable& table, const std::vector<GroupKey>& keys, StudentColumn value,
+                   std::vector<GroupResult>& out, const GroupByOptions& options = GroupByOptions());
+
+// Parses "iq:10,internship" into keys. False if a column name or width is bad.
+bool parseGroupKeys(const std::string& text, std::vector<GroupKey>& keys);
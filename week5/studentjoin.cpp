@@ -0,0 +1,466 @@
+#include "studentjoin.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include "../common/cpu.h"
+#include "../common/mappedfile.h"
+
+/*
+This source file implements AuxTable loading, the hash joins and the
+CSV writer declared in studentjoin.h.
+*/
+
+const size_t ParallelRows = 65536; // Fewer rows per thread join on one thread
+
+// ---------------------------------------------------------------- AuxTable
+
+size_t AuxTable::size() const {
+    return columns.empty() || offsets.empty() ? 0 : (offsets.size() - 1) / columns.size();
+}
+
+std::string_view AuxTable::field(size_t row, size_t column) const {
+    size_t i = row * columns.size() + column;
+    return std::string_view(arena.data() + offsets[i], offsets[i + 1] - offsets[i]);
+}
+
+std::string_view AuxTable::key(size_t row) const {
+    return field(row, keyColumn);
+}
+
+static std::string lowerCase(std::string_view text) {
+    std::string result(text);
+    for (char& ch : result) ch = (char)std::tolower((unsigned char)ch);
+    return result;
+}
+
+bool loadAuxTable(const std::string& path, AuxTable& table, LoadStats& stats, const std::string& keyName) {
+    MappedFile file;
+    if (!file.open(path)) return false;
+    stats = LoadStats();
+    stats.bytes = file.size();
+    table = AuxTable();
+
+    const char* p = file.data();
+    const char* end = p + file.size();
+    auto nextLine = [&](const char*& lineEnd) {
+        const char* nl = (const char*)std::memchr(p, '\n', (size_t)(end - p));
+        lineEnd = nl ? nl : end;
+        const char* start = p;
+        p = nl ? nl + 1 : end;
+        if (lineEnd > start && lineEnd[-1] == '\r') lineEnd--; // Windows line endings
+        return start;
+    };
+
+    // Header row: column names and the key column
+    const char* lineEnd;
+    const char* line = nextLine(lineEnd);
+    while (true) {
+        const char* comma = (const char*)std::memchr(line, ',', (size_t)(lineEnd - line));
+        const char* stop = comma ? comma : lineEnd;
+        table.columns.emplace_back(line, stop);
+        if (!comma) break;
+        line = comma + 1;
+    }
+    std::string wanted = lowerCase(keyName);
+    auto key = std::find_if(table.columns.begin(), table.columns.end(),
+                            [&](const std::string& name) { return lowerCase(name) == wanted; });
+    if (key == table.columns.end()) return false;
+    table.keyColumn = (size_t)(key - table.columns.begin());
+
+    size_t fields = table.columns.size();
+    table.arena.reserve(file.size());
+    table.offsets.reserve(file.size() / 8);
+    table.offsets.push_back(0);
+    while (p < end) {
+        line = nextLine(lineEnd);
+        if (line == lineEnd) continue; // Blank line
+
+        size_t before = table.offsets.size();
+        size_t count = 0;
+        const char* f = line;
+        while (true) {
+            const char* comma = (const char*)std::memchr(f, ',', (size_t)(lineEnd - f));
+            const char* stop = comma ? comma : lineEnd;
+            table.arena.insert(table.arena.end(), f, stop);
+            table.offsets.push_back((uint32_t)table.arena.size());
+            count++;
+            if (!comma) break;
+            f = comma + 1;
+        }
+        if (count != fields) {
+            // Roll the malformed row back out of the arena
+            table.offsets.resize(before);
+            table.arena.resize(table.offsets.back());
+            stats.badRows++;
+        }
+    }
+    stats.rows = table.size();
+    return true;
+}
+
+// ---------------------------------------------------------------- Hashing
+
+// murmur3's 64-bit finalizer: every input bit affects every output bit
+static uint64_t mix64(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+// 64-bit hash of a long key, 8 bytes at a time
+static uint64_t hashKey(std::string_view key) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ (uint64_t)key.size();
+    size_t i = 0;
+    for (; i + 8 <= key.size(); i += 8) {
+        uint64_t w;
+        std::memcpy(&w, key.data() + i, 8);
+        h = (h ^ w) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, key.data() + i, key.size() - i);
+    return mix64(h ^ tail);
+}
+
+namespace {
+
+// A key's hash plus, for keys up to 15 bytes, the key itself: bytes 0-14 with the length in
+// byte 15. Longer keys store 0xFF there and are compared in the table arenas instead.
+// Equal codes of short keys mean equal keys, so most probes never touch the arenas.
+struct KeyCode {
+    uint64_t hash;
+    uint64_t lo, hi;
+
+    bool operator==(const KeyCode& other) const {
+        return hash == other.hash && lo == other.lo && hi == other.hi;
+    }
+    bool isShort() const { return (hi >> 56) != 0xFF; }
+};
+
+}
+
+static KeyCode keyCode(std::string_view key) {
+    unsigned char bytes[16] = {};
+    size_t n = key.size() <= 15 ? key.size() : 15;
+    std::memcpy(bytes, key.data(), n);
+    bytes[15] = key.size() <= 15 ? (unsigned char)key.size() : 0xFF;
+
+    KeyCode code;
+    std::memcpy(&code.lo, bytes, 8);
+    std::memcpy(&code.hi, bytes + 8, 8);
+    // Short keys hash their code words directly; the hash drives partitions (top bits) and buckets (low bits)
+    code.hash = key.size() <= 15 ? mix64(code.lo ^ mix64(code.hi + 0x9E3779B97F4A7C15ull)) : hashKey(key);
+    return code;
+}
+
+// HyperLogLog with 4096 registers (about 1.6% error), linear counting for small sets
+static size_t estimateDistinct(const std::vector<KeyCode>& codes) {
+    const int IndexBits = 12;
+    const size_t Registers = (size_t)1 << IndexBits;
+    std::vector<uint8_t> rank(Registers, 0);
+    for (const KeyCode& code : codes) {
+        uint64_t h = code.hash;
+        size_t index = (size_t)(h >> (64 - IndexBits));
+        uint64_t rest = (h << IndexBits) | ((uint64_t)1 << (IndexBits - 1)); // Caps the rank
+        uint8_t r = 1;
+        while (!(rest & 0x8000000000000000ull)) {
+            rest <<= 1;
+            r++;
+        }
+        rank[index] = std::max(rank[index], r);
+    }
+
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t r : rank) {
+        sum += std::ldexp(1.0, -r);
+        zeros += r == 0;
+    }
+    double m = (double)Registers;
+    double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0) estimate = m * std::log(m / (double)zeros);
+    return (size_t)estimate + 1;
+}
+
+// ---------------------------------------------------------------- Hash table
+
+namespace {
+
+// Build side of one hash join: chained buckets over a list of AuxTable rows
+struct BuildSide {
+    const uint32_t* rows = nullptr;    // AuxTable row of each entry; null means entry i is row i
+    const KeyCode* keys = nullptr;     // Code of each entry's key
+    size_t count = 0;
+    std::vector<uint32_t> heads;       // First entry of each bucket
+    std::vector<uint32_t> next;        // Next entry in the same bucket
+    uint64_t mask = 0;
+
+    uint32_t row(uint32_t entry) const { return rows ? rows[entry] : entry; }
+};
+
+// Probe-side rows of one join task and where its pairs go
+struct ProbeSide {
+    const uint32_t* rows = nullptr;    // Student row of each entry; null means entry i is row i
+    const KeyCode* keys = nullptr;
+    size_t begin = 0, end = 0;
+};
+
+struct PairList {
+    std::vector<uint32_t> left;
+    std::vector<uint32_t> right;
+};
+
+}
+
+static void buildTable(BuildSide& build, size_t distinct) {
+    size_t buckets = 16;
+    while (buckets < distinct * 2) buckets *= 2; // About half the buckets used, short chains
+    build.heads.assign(buckets, NoMatch);
+    build.next.resize(build.count);
+    build.mask = buckets - 1;
+    // Insert back to front so every chain lists entries in ascending row order
+    for (size_t e = build.count; e-- > 0;) {
+        size_t bucket = (size_t)(build.keys[e].hash & build.mask);
+        build.next[e] = build.heads[bucket];
+        build.heads[bucket] = (uint32_t)e;
+    }
+}
+
+static void probeTable(const BuildSide& build, const ProbeSide& probe, const StudentTable& students,
+                       const AuxTable& aux, bool leftJoin, PairList& out) {
+    for (size_t i = probe.begin; i < probe.end; i++) {
+        uint32_t student = probe.rows ? probe.rows[i] : (uint32_t)i;
+        const KeyCode& code = probe.keys[i];
+        bool matched = false;
+        for (uint32_t e = build.heads[code.hash & build.mask]; e != NoMatch; e = build.next[e]) {
+            if (!(build.keys[e] == code)) continue;
+            uint32_t row = build.row(e);
+            if (!code.isShort() && aux.key(row) != students.collegeId(student)) continue;
+            out.left.push_back(student);
+            out.right.push_back(row);
+            matched = true;
+        }
+        if (!matched && leftJoin) {
+            out.left.push_back(student);
+            out.right.push_back(NoMatch);
+        }
+    }
+}
+
+// Runs fn(i) for i in [0, n) over threads slices
+template <typename Fn>
+static void forEachRow(size_t n, int threads, Fn fn) {
+    runSlices(n, threads, [&](int, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) fn(i);
+    });
+}
+
+// Stable parallel counting sort of rows 0..n-1 into partitions by the top bits of their key hash.
+// Keys are encoded once to count and again while scattering, so no unpartitioned copy is kept.
+template <typename KeyOf>
+static void partitionKeys(size_t n, int bits, int threads, KeyOf keyOf, std::vector<uint32_t>& rows,
+                          std::vector<KeyCode>& codes, std::vector<size_t>& starts) {
+    size_t partitions = (size_t)1 << bits;
+    std::vector<size_t> counts((size_t)threads * partitions, 0);
+    runSlices(n, threads, [&](int slice, size_t begin, size_t end) {
+        size_t* count = counts.data() + slice * partitions;
+        for (size_t i = begin; i < end; i++) count[keyCode(keyOf(i)).hash >> (64 - bits)]++;
+    });
+
+    // Partition-major, slice-minor offsets keep rows in ascending order inside a partition
+    starts.assign(partitions + 1, 0);
+    size_t offset = 0;
+    for (size_t p = 0; p < partitions; p++) {
+        starts[p] = offset;
+        for (int t = 0; t < threads; t++) {
+            size_t c = counts[t * partitions + p];
+            counts[t * partitions + p] = offset;
+            offset += c;
+        }
+    }
+    starts[partitions] = offset;
+
+    rows.resize(n);
+    codes.resize(n);
+    runSlices(n, threads, [&](int slice, size_t begin, size_t end) {
+        size_t* next = counts.data() + slice * partitions;
+        uint32_t* rowOut = rows.data();
+        KeyCode* codeOut = codes.data();
+        // Encode a block, then scatter it: interleaving the two doubles the scatter cost
+        KeyCode block[256];
+        for (size_t b = begin; b < end; b += 256) {
+            size_t m = std::min<size_t>(256, end - b);
+            for (size_t j = 0; j < m; j++) block[j] = keyCode(keyOf(b + j));
+            for (size_t j = 0; j < m; j++) {
+                size_t dst = next[block[j].hash >> (64 - bits)]++;
+                rowOut[dst] = (uint32_t)(b + j);
+                codeOut[dst] = block[j];
+            }
+        }
+    });
+}
+
+// ---------------------------------------------------------------- Join
+
+size_t JoinResult::size() const {
+    return left.size();
+}
+
+JoinResult joinStudents(const StudentTable& students, const AuxTable& aux, const JoinOptions& options) {
+    JoinResult result;
+    bool leftJoin = options.type == JoinType::Left;
+    size_t probeCount = students.size(), buildCount = aux.size();
+
+    int threads = sliceCount(probeCount + buildCount, options.threads, ParallelRows);
+
+    auto auxKey = [&](size_t row) { return aux.key(row); };
+    auto studentKey = [&](size_t row) { return students.collegeId(row); };
+
+    if (buildCount <= options.partitionRows) {
+        // One shared hash table, probed by every thread over its own slice of students
+        std::vector<KeyCode> buildKeys(buildCount), probeKeys(probeCount);
+        forEachRow(buildCount, threads, [&](size_t i) { buildKeys[i] = keyCode(auxKey(i)); });
+        forEachRow(probeCount, threads, [&](size_t i) { probeKeys[i] = keyCode(studentKey(i)); });
+        result.distinctEstimate = estimateDistinct(buildKeys);
+
+        BuildSide build;
+        build.keys = buildKeys.data();
+        build.count = buildCount;
+        buildTable(build, result.distinctEstimate);
+
+        std::vector<PairList> parts(threads);
+        runSlices(probeCount, threads, [&](int slice, size_t begin, size_t end) {
+            ProbeSide probe;
+            probe.keys = probeKeys.data();
+            probe.begin = begin;
+            probe.end = end;
+            parts[slice].left.reserve(end - begin);
+            parts[slice].right.reserve(end - begin);
+            probeTable(build, probe, students, aux, leftJoin, parts[slice]);
+        });
+        for (PairList& part : parts) {
+            result.left.insert(result.left.end(), part.left.begin(), part.left.end());
+            result.right.insert(result.right.end(), part.right.begin(), part.right.end());
+        }
+        return result;
+    }
+
+    // Partitioned (radix) join: about partitionRows / 8 AuxTable rows per partition,
+    // so each partition's hash table stays cache resident
+    int bits = 1;
+    while (bits < 12 && (buildCount >> bits) > options.partitionRows / 8) bits++;
+    size_t partitions = (size_t)1 << bits;
+    result.partitions = partitions;
+
+    std::vector<uint32_t> buildRows, probeRows;
+    std::vector<KeyCode> buildKeys, probeKeys;
+    std::vector<size_t> buildStarts, probeStarts;
+    partitionKeys(buildCount, bits, threads, auxKey, buildRows, buildKeys, buildStarts);
+    partitionKeys(probeCount, bits, threads, studentKey, probeRows, probeKeys, probeStarts);
+    result.distinctEstimate = estimateDistinct(buildKeys);
+
+    std::vector<PairList> parts(partitions);
+    std::atomic<size_t> nextPartition(0);
+    runSlices(partitions, threads, [&](int, size_t, size_t) {
+        BuildSide build;
+        for (size_t p; (p = nextPartition++) < partitions;) {
+            build.rows = buildRows.data() + buildStarts[p];
+            build.keys = buildKeys.data() + buildStarts[p];
+            build.count = buildStarts[p + 1] - buildStarts[p];
+            buildTable(build, result.distinctEstimate / partitions + 1);
+
+            ProbeSide probe;
+            probe.rows = probeRows.data();
+            probe.keys = probeKeys.data();
+            probe.begin = probeStarts[p];
+            probe.end = probeStarts[p + 1];
+            probeTable(build, probe, students, aux, leftJoin, parts[p]);
+        }
+    });
+
+    // Partition outputs interleave students; scatter them back into student order.
+    // Within a student all pairs come from one partition, already in AuxTable row order.
+    std::vector<size_t> offsets(probeCount + 1, 0);
+    for (const PairList& part : parts) {
+        for (uint32_t s : part.left) offsets[s + 1]++;
+    }
+    for (size_t s = 0; s < probeCount; s++) offsets[s + 1] += offsets[s];
+    result.left.resize(offsets[probeCount]);
+    result.right.resize(offsets[probeCount]);
+    for (const PairList& part : parts) {
+        for (size_t i = 0; i < part.left.size(); i++) {
+            size_t dst = offsets[part.left[i]]++;
+            result.left[dst] = part.left[i];
+            result.right[dst] = part.right[i];
+        }
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------- Output
+
+StudentTable takeStudentRows(const StudentTable& table, const std::vector<uint32_t>& rows) {
+    StudentTable result;
+    size_t idBytes = 0;
+    for (uint32_t r : rows) idBytes += table.collegeId(r).size();
+    result.reserve(rows.size(), idBytes);
+    for (uint32_t r : rows) {
+        std::string_view id = table.collegeId(r);
+        result.id_arena.append(id.begin(), id.end());
+        result.id_offsets.push_back((uint32_t)result.id_arena.size());
+        result.iq.push_back(table.iq[r]);
+        result.prev_sem_result.push_back(table.prev_sem_result[r]);
+        result.cgpa.push_back(table.cgpa[r]);
+        result.academic_performance.push_back(table.academic_performance[r]);
+        result.internship_experience.push_back(table.internship_experience[r]);
+        result.extra_curricular_score.push_back(table.extra_curricular_score[r]);
+        result.communication_skills.push_back(table.communication_skills[r]);
+        result.projects_completed.push_back(table.projects_completed[r]);
+        result.placement.push_back(table.placement[r]);
+    }
+    return result;
+}
+
+bool writeJoinCsv(const std::string& path, const StudentTable& students, const AuxTable& aux,
+                  const JoinResult& result) {
+    ReportWriter out;
+    if (!out.open(path)) return false;
+
+    std::vector<ReportColumn> columns;
+    for (const char* name : {"College_ID", "IQ", "Prev_Sem_Result", "CGPA", "Academic_Performance",
+                             "Internship_Experience", "Extra_Curricular_Score", "Communication_Skills",
+                             "Projects_Completed", "Placement"}) {
+        columns.push_back({name});
+    }
+    for (size_t c = 0; c < aux.columns.size(); c++) {
+        if (c != aux.keyColumn) columns.push_back({aux.columns[c]});
+    }
+    out.begin(ReportFormat::Csv, columns);
+
+    for (size_t i = 0; i < result.size(); i++) {
+        uint32_t s = result.left[i];
+        out.text(students.collegeId(s));
+        out.integer(students.iq[s]);
+        out.number(students.prev_sem_result[s]);
+        out.number(students.cgpa[s]);
+        out.integer(students.academic_performance[s]);
+        out.yesNo(students.internship_experience[s]);
+        out.integer(students.extra_curricular_score[s]);
+        out.integer(students.communication_skills[s]);
+        out.integer(students.projects_completed[s]);
+        out.yesNo(students.placement[s]);
+
+        uint32_t r = result.right[i];
+        for (size_t c = 0; c < aux.columns.size(); c++) {
+            if (c == aux.keyColumn) continue;
+            out.text(r != NoMatch ? aux.field(r, c) : std::string_view()); // Left-join misses leave the fields empty
+        }
+        out.endRow();
+    }
+    return out.close();
+}
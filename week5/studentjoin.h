@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "studenttable.h"
+
+/*
+This header file defines joins between the student dataset and other
+College_ID-keyed CSV files (company offers, interview logs, ...).
+
+AuxTable holds any such CSV with all fields packed into one character
+arena. joinStudents() matches every student with the AuxTable rows that
+have the same College_ID (inner join), or keeps students without a
+match too (left join). The AuxTable side is put in a chained hash table
+sized from a HyperLogLog estimate of its distinct keys. When that table
+would not fit in cache, both sides are first radix-partitioned by key
+hash and each partition is joined on its own, in parallel.
+
+The result is columnar: two aligned vectors of row numbers. It can be
+materialized with takeStudentRows() or streamed to a CSV file with
+writeJoinCsv().
+*/
+
+const uint32_t NoMatch = 0xFFFFFFFFu; // Right row of a left-join row without a match
+
+// A CSV file kept as text, one arena for every field
+class AuxTable {
+public:
+    std::vector<std::string> columns;  // Header names
+    size_t keyColumn = 0;              // Index of the College_ID column
+    std::vector<char> arena;           // Field bytes, row by row
+    std::vector<uint32_t> offsets;     // Field f of row r is arena[offsets[i] .. offsets[i + 1]), i = r * columns + f
+
+    size_t size() const;                                     // Number of rows
+    std::string_view field(size_t row, size_t column) const; // One field of a row
+    std::string_view key(size_t row) const;                  // College_ID of a row
+};
+
+// Loads a comma-separated file with a header row; keyName picks the join column (case-insensitive).
+// Rows with the wrong number of fields are skipped and counted. False if the file or key column is missing.
+bool loadAuxTable(const std::string& path, AuxTable& table, LoadStats& stats,
+                  const std::string& keyName = "College_ID");
+
+enum class JoinType { Inner, Left };
+
+struct JoinOptions {
+    JoinType type = JoinType::Inner;
+    int threads = 0;                   // 0 uses every hardware thread
+    size_t partitionRows = 1 << 17;    // AuxTable rows above which the partitioned path is used
+};
+
+// Matched row pairs ordered by student row, then AuxTable row
+struct JoinResult {
+    std::vector<uint32_t> left;        // Student rows
+    std::vector<uint32_t> right;       // AuxTable rows, NoMatch for unmatched left-join students
+    size_t distinctEstimate = 0;       // Estimated distinct AuxTable keys
+    size_t partitions = 1;             // 1 when the whole AuxTable fit in one hash table
+
+    size_t size() const;
+};
+
+JoinResult joinStudents(const StudentTable& students, const AuxTable& aux, const JoinOptions& options = JoinOptions());
+
+// Copies the given rows (in order) of a StudentTable into a new one
+StudentTable takeStudentRows(const StudentTable& table, const std::vector<uint32_t>& rows);
+
+// Writes the joined rows as CSV: the student columns, then every AuxTable column but the key.
+// Output goes through a ReportWriter, so fields that hold commas or quotes are quoted. False if the
+// file cannot be written.
+bool writeJoinCsv(const std::string& path, const StudentTable& students, const AuxTable& aux,
+                  const JoinResult& result);
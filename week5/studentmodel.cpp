@@ -0,0 +1,500 @@
+#include "studentmodel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "../common/cpu.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define STUDENT_MODEL_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+This source file implements feature scaling, the SIMD kernels and the
+logistic regression and kNN models declared in studentmodel.h.
+*/
+
+const size_t BlockRows = 1024;              // Rows standardized and scored together
+const size_t ParallelRows = 4 * BlockRows;  // Fewer rows per thread run on one thread
+
+// ---------------------------------------------------------------- Features
+
+const float* FeatureMatrix::column(int feature) const {
+    return values.data() + (size_t)feature * rows;
+}
+
+// Calls fn(column) with the table column behind feature f
+template <typename Fn>
+static void withFeature(const StudentTable& table, int feature, Fn fn) {
+    switch (feature) {
+    case 0: fn(table.iq); break;
+    case 1: fn(table.prev_sem_result); break;
+    case 2: fn(table.cgpa); break;
+    case 3: fn(table.academic_performance); break;
+    case 4: fn(table.internship_experience); break;
+    case 5: fn(table.extra_curricular_score); break;
+    case 6: fn(table.communication_skills); break;
+    default: fn(table.projects_completed); break;
+    }
+}
+
+static size_t rowCount(const StudentTable& table, const std::vector<uint32_t>* rows) {
+    return rows ? rows->size() : table.size();
+}
+
+// Standardizes rows [begin, end) of the row list: feature f of row i goes to out[f * stride + i - begin]
+static void fillBlock(const FeatureScaling& scaling, const StudentTable& table, const std::vector<uint32_t>* rows,
+                      size_t begin, size_t end, float* out, size_t stride) {
+    for (int f = 0; f < FeatureCount; f++) {
+        float mean = scaling.mean[f], inverseStd = scaling.inverseStd[f];
+        float* dst = out + (size_t)f * stride;
+        withFeature(table, f, [&](const auto& column) {
+            if (rows) {
+                for (size_t i = begin; i < end; i++) dst[i - begin] = ((float)column[(*rows)[i]] - mean) * inverseStd;
+            } else {
+                for (size_t i = begin; i < end; i++) dst[i - begin] = ((float)column[i] - mean) * inverseStd;
+            }
+        });
+    }
+}
+
+void FeatureScaling::fit(const StudentTable& table, const std::vector<uint32_t>* rows) {
+    size_t n = rowCount(table, rows);
+    for (int f = 0; f < FeatureCount; f++) {
+        double sum = 0, sumSq = 0;
+        withFeature(table, f, [&](const auto& column) {
+            for (size_t i = 0; i < n; i++) {
+                double x = (double)column[rows ? (*rows)[i] : i];
+                sum += x;
+                sumSq += x * x;
+            }
+        });
+        double m = n ? sum / n : 0;
+        double variance = n ? std::max(sumSq / n - m * m, 0.0) : 0;
+        mean[f] = (float)m;
+        inverseStd[f] = variance > 1e-12 ? (float)(1 / std::sqrt(variance)) : 1.0f; // Constant feature: all zeros
+    }
+}
+
+FeatureMatrix FeatureScaling::apply(const StudentTable& table, const std::vector<uint32_t>* rows) const {
+    FeatureMatrix matrix;
+    matrix.rows = rowCount(table, rows);
+    matrix.values.resize((size_t)FeatureCount * matrix.rows);
+    matrix.labels.resize(matrix.rows);
+    fillBlock(*this, table, rows, 0, matrix.rows, matrix.values.data(), matrix.rows);
+    for (size_t i = 0; i < matrix.rows; i++) matrix.labels[i] = table.placement[rows ? (*rows)[i] : i];
+    return matrix;
+}
+
+// ---------------------------------------------------------------- Scalar kernels
+
+// exp(x) as 2^n * 2^f with |f| <= 0.5 and a degree-5 polynomial for 2^f; sigmoid stays within 5e-6 relative.
+// Every kernel set uses the same steps so they agree to the last few bits.
+const float Log2e = 1.44269504f;
+const float Exp2C[6] = {1.0f, 0.693147182f, 0.240226507f, 0.0555041087f, 0.00961812911f, 0.00133335581f};
+const float LogitClamp = 30.0f; // sigmoid(30) rounds to 1 in float
+
+static float sigmoid(float z) {
+    z = std::min(std::max(z, -LogitClamp), LogitClamp);
+    float t = -z * Log2e;
+    float n = std::nearbyint(t);
+    float f = t - n;
+    float p = Exp2C[5];
+    for (int c = 4; c >= 0; c--) p = p * f + Exp2C[c];
+    uint32_t bits;
+    std::memcpy(&bits, &p, 4);
+    bits += (uint32_t)(int32_t)n << 23; // Adds n to the exponent
+    std::memcpy(&p, &bits, 4);
+    return 1.0f / (1.0f + p);
+}
+
+static void probabilitiesScalar(const float* const* x, size_t n, const float* w, float b, float* out) {
+    for (size_t i = 0; i < n; i++) {
+        float z = b;
+        for (int f = 0; f < FeatureCount; f++) z += w[f] * x[f][i];
+        out[i] = sigmoid(z);
+    }
+}
+
+static void gradientScalar(const float* const* x, const float* y, size_t n, const float* w, float b, float* grad) {
+    std::fill(grad, grad + FeatureCount + 1, 0.0f);
+    for (size_t i = 0; i < n; i++) {
+        float z = b;
+        for (int f = 0; f < FeatureCount; f++) z += w[f] * x[f][i];
+        float e = sigmoid(z) - y[i];
+        for (int f = 0; f < FeatureCount; f++) grad[f] += e * x[f][i];
+        grad[FeatureCount] += e;
+    }
+}
+
+static void distancesScalar(const float* const* x, size_t n, const float* q, float* out) {
+    for (size_t i = 0; i < n; i++) {
+        float d = 0;
+        for (int f = 0; f < FeatureCount; f++) {
+            float diff = x[f][i] - q[f];
+            d += diff * diff;
+        }
+        out[i] = d;
+    }
+}
+
+// ---------------------------------------------------------------- AVX2 / AVX-512 kernels
+
+#ifdef STUDENT_MODEL_X86
+
+#if defined(__GNUC__) || defined(__clang__)
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+#define AVX512_TARGET __attribute__((target("avx512f")))
+#else
+#define AVX2_TARGET
+#define AVX512_TARGET
+#endif
+
+AVX2_TARGET static __m256 sigmoidAvx2(__m256 z) {
+    z = _mm256_min_ps(_mm256_max_ps(z, _mm256_set1_ps(-LogitClamp)), _mm256_set1_ps(LogitClamp));
+    __m256 t = _mm256_mul_ps(z, _mm256_set1_ps(-Log2e));
+    __m256 n = _mm256_round_ps(t, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 f = _mm256_sub_ps(t, n);
+    __m256 p = _mm256_set1_ps(Exp2C[5]);
+    for (int c = 4; c >= 0; c--) p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(Exp2C[c]));
+    __m256i bits = _mm256_add_epi32(_mm256_castps_si256(p), _mm256_slli_epi32(_mm256_cvtps_epi32(n), 23));
+    __m256 one = _mm256_set1_ps(1.0f);
+    return _mm256_div_ps(one, _mm256_add_ps(one, _mm256_castsi256_ps(bits)));
+}
+
+AVX2_TARGET static float sumAvx2(__m256 v) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_movehdup_ps(s));
+    return _mm_cvtss_f32(s);
+}
+
+AVX2_TARGET static void probabilitiesAvx2(const float* const* x, size_t n, const float* w, float b, float* out) {
+    __m256 weight[FeatureCount];
+    for (int f = 0; f < FeatureCount; f++) weight[f] = _mm256_set1_ps(w[f]);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 z = _mm256_set1_ps(b);
+        for (int f = 0; f < FeatureCount; f++) z = _mm256_fmadd_ps(weight[f], _mm256_loadu_ps(x[f] + i), z);
+        _mm256_storeu_ps(out + i, sigmoidAvx2(z));
+    }
+    const float* tail[FeatureCount];
+    for (int f = 0; f < FeatureCount; f++) tail[f] = x[f] + i;
+    probabilitiesScalar(tail, n - i, w, b, out + i);
+}
+
+AVX2_TARGET static void gradientAvx2(const float* const* x, const float* y, size_t n, const float* w, float b,
+                                     float* grad) {
+    __m256 weight[FeatureCount], acc[FeatureCount + 1];
+    for (int f = 0; f < FeatureCount; f++) weight[f] = _mm256_set1_ps(w[f]);
+    for (int f = 0; f <= FeatureCount; f++) acc[f] = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 column[FeatureCount];
+        __m256 z = _mm256_set1_ps(b);
+        for (int f = 0; f < FeatureCount; f++) {
+            column[f] = _mm256_loadu_ps(x[f] + i);
+            z = _mm256_fmadd_ps(weight[f], column[f], z);
+        }
+        __m256 e = _mm256_sub_ps(sigmoidAvx2(z), _mm256_loadu_ps(y + i));
+        for (int f = 0; f < FeatureCount; f++) acc[f] = _mm256_fmadd_ps(e, column[f], acc[f]);
+        acc[FeatureCount] = _mm256_add_ps(acc[FeatureCount], e);
+    }
+    const float* tail[FeatureCount];
+    for (int f = 0; f < FeatureCount; f++) tail[f] = x[f] + i;
+    gradientScalar(tail, y + i, n - i, w, b, grad);
+    for (int f = 0; f <= FeatureCount; f++) grad[f] += sumAvx2(acc[f]);
+}
+
+AVX2_TARGET static void distancesAvx2(const float* const* x, size_t n, const float* q, float* out) {
+    __m256 query[FeatureCount];
+    for (int f = 0; f < FeatureCount; f++) query[f] = _mm256_set1_ps(q[f]);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 d = _mm256_setzero_ps();
+        for (int f = 0; f < FeatureCount; f++) {
+            __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(x[f] + i), query[f]);
+            d = _mm256_fmadd_ps(diff, diff, d);
+        }
+        _mm256_storeu_ps(out + i, d);
+    }
+    const float* tail[FeatureCount];
+    for (int f = 0; f < FeatureCount; f++) tail[f] = x[f] + i;
+    distancesScalar(tail, n - i, q, out + i);
+}
+
+// GCC 12's AVX-512 headers trip -Wuninitialized on their own _mm512_undefined_* placeholders
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+AVX512_TARGET static __m512 sigmoidAvx512(__m512 z) {
+    z = _mm512_min_ps(_mm512_max_ps(z, _mm512_set1_ps(-LogitClamp)), _mm512_set1_ps(LogitClamp));
+    __m512 t = _mm512_mul_ps(z, _mm512_set1_ps(-Log2e));
+    __m512 n = _mm512_roundscale_ps(t, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512 f = _mm512_sub_ps(t, n);
+    __m512 p = _mm512_set1_ps(Exp2C[5]);
+    for (int c = 4; c >= 0; c--) p = _mm512_fmadd_ps(p, f, _mm512_set1_ps(Exp2C[c]));
+    __m512i bits = _mm512_add_epi32(_mm512_castps_si512(p), _mm512_slli_epi32(_mm512_cvtps_epi32(n), 23));
+    __m512 one = _mm512_set1_ps(1.0f);
+    return _mm512_div_ps(one, _mm512_add_ps(one, _mm512_castsi512_ps(bits)));
+}
+
+AVX512_TARGET static void probabilitiesAvx512(const float* const* x, size_t n, const float* w, float b, float* out) {
+    __m512 weight[FeatureCount];
+    for (int f = 0; f < FeatureCount; f++) weight[f] = _mm512_set1_ps(w[f]);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 z = _mm512_set1_ps(b);
+        for (int f = 0; f < FeatureCount; f++) z = _mm512_fmadd_ps(weight[f], _mm512_loadu_ps(x[f] + i), z);
+        _mm512_storeu_ps(out + i, sigmoidAvx512(z));
+    }
+    const float* tail[FeatureCount];
+    for (int f = 0; f < FeatureCount; f++) tail[f] = x[f] + i;
+    probabilitiesScalar(tail, n - i, w, b, out + i);
+}
+
+AVX512_TARGET static void gradientAvx512(const float* const* x, const float* y, size_t n, const float* w, float b,
+                                         float* grad) {
+    __m512 weight[FeatureCount], acc[FeatureCount + 1];
+    for (int f = 0; f < FeatureCount; f++) weight[f] = _mm512_set1_ps(w[f]);
+    for (int f = 0; f <= FeatureCount; f++) acc[f] = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 column[FeatureCount];
+        __m512 z = _mm512_set1_ps(b);
+        for (int f = 0; f < FeatureCount; f++) {
+            column[f] = _mm512_loadu_ps(x[f] + i);
+            z = _mm512_fmadd_ps(weight[f], column[f], z);
+        }
+        __m512 e = _mm512_sub_ps(sigmoidAvx512(z), _mm512_loadu_ps(y + i));
+        for (int f = 0; f < FeatureCount; f++) acc[f] = _mm512_fmadd_ps(e, column[f], acc[f]);
+        acc[FeatureCount] = _mm512_add_ps(acc[FeatureCount], e);
+    }
+    const float* tail[FeatureCount];
+    for (int f = 0; f < FeatureCount; f++) tail[f] = x[f] + i;
+    gradientScalar(tail, y + i, n - i, w, b, grad);
+    for (int f = 0; f <= FeatureCount; f++) grad[f] += _mm512_reduce_add_ps(acc[f]);
+}
+
+AVX512_TARGET static void distancesAvx512(const float* const* x, size_t n, const float* q, float* out) {
+    __m512 query[FeatureCount];
+    for (int f = 0; f < FeatureCount; f++) query[f] = _mm512_set1_ps(q[f]);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 d = _mm512_setzero_ps();
+        for (int f = 0; f < FeatureCount; f++) {
+            __m512 diff = _mm512_sub_ps(_mm512_loadu_ps(x[f] + i), query[f]);
+            d = _mm512_fmadd_ps(diff, diff, d);
+        }
+        _mm512_storeu_ps(out + i, d);
+    }
+    const float* tail[FeatureCount];
+    for (int f = 0; f < FeatureCount; f++) tail[f] = x[f] + i;
+    distancesScalar(tail, n - i, q, out + i);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+// ---------------------------------------------------------------- Kernel selection
+
+struct Kernels {
+    const char* name;
+    void (*probabilities)(const float* const* x, size_t n, const float* w, float b, float* out);
+    void (*gradient)(const float* const* x, const float* y, size_t n, const float* w, float b, float* grad);
+    void (*distances)(const float* const* x, size_t n, const float* q, float* out);
+};
+
+static Kernels pickKernels() {
+#ifdef STUDENT_MODEL_X86
+    const CpuFeatures& cpu = cpuFeatures();
+    if (cpu.avx512f) return {"AVX-512", probabilitiesAvx512, gradientAvx512, distancesAvx512};
+    if (cpu.avx2 && cpu.fma) return {"AVX2", probabilitiesAvx2, gradientAvx2, distancesAvx2};
+#endif
+    return {"scalar", probabilitiesScalar, gradientScalar, distancesScalar};
+}
+
+static const Kernels& kernels() {
+    static const Kernels chosen = pickKernels();
+    return chosen;
+}
+
+const char* modelKernelName() {
+    return kernels().name;
+}
+
+// ---------------------------------------------------------------- Logistic regression
+
+void LogisticModel::train(const StudentTable& table, const std::vector<uint32_t>* rows,
+                          const LogisticOptions& options) {
+    scaling.fit(table, rows);
+    std::fill(weights, weights + FeatureCount, 0.0f);
+    bias = 0;
+    FeatureMatrix m = scaling.apply(table, rows);
+    if (m.rows == 0) return;
+
+    const Kernels& kernel = kernels();
+    int threads = sliceCount(m.rows, options.threads, ParallelRows);
+    std::vector<double> partial((size_t)threads * (FeatureCount + 1));
+    for (int epoch = 0; epoch < options.epochs; epoch++) {
+        // Gradient of the mean log loss: float sums per block, double across blocks and slices
+        runSlices(m.rows, threads, [&](int slice, size_t begin, size_t end) {
+            double* sum = partial.data() + (size_t)slice * (FeatureCount + 1);
+            std::fill(sum, sum + FeatureCount + 1, 0.0);
+            for (size_t b = begin; b < end; b += BlockRows) {
+                size_t n = std::min(BlockRows, end - b);
+                const float* x[FeatureCount];
+                for (int f = 0; f < FeatureCount; f++) x[f] = m.column(f) + b;
+                float grad[FeatureCount + 1];
+                kernel.gradient(x, m.labels.data() + b, n, weights, bias, grad);
+                for (int f = 0; f <= FeatureCount; f++) sum[f] += grad[f];
+            }
+        });
+
+        double largest = 0;
+        for (int f = 0; f <= FeatureCount; f++) {
+            double g = 0;
+            for (int t = 0; t < threads; t++) g += partial[(size_t)t * (FeatureCount + 1) + f];
+            g /= (double)m.rows;
+            if (f < FeatureCount) {
+                g += options.l2 * weights[f];
+                weights[f] -= (float)(options.learningRate * g);
+            } else {
+                bias -= (float)(options.learningRate * g);
+            }
+            largest = std::max(largest, std::fabs(g));
+        }
+        if (largest < 1e-5) break; // Converged
+    }
+}
+
+std::vector<float> LogisticModel::score(const StudentTable& table, const std::vector<uint32_t>* rows,
+                                        int threads) const {
+    size_t n = rowCount(table, rows);
+    std::vector<float> result(n);
+    const Kernels& kernel = kernels();
+    runSlices(n, sliceCount(n, threads, ParallelRows), [&](int, size_t begin, size_t end) {
+        std::vector<float> block((size_t)FeatureCount * BlockRows);
+        for (size_t b = begin; b < end; b += BlockRows) {
+            size_t count = std::min(BlockRows, end - b);
+            fillBlock(scaling, table, rows, b, b + count, block.data(), BlockRows);
+            const float* x[FeatureCount];
+            for (int f = 0; f < FeatureCount; f++) x[f] = block.data() + (size_t)f * BlockRows;
+            kernel.probabilities(x, count, weights, bias, result.data() + b);
+        }
+    });
+    return result;
+}
+
+// ---------------------------------------------------------------- kNN
+
+void KnnModel::train(const StudentTable& table, const std::vector<uint32_t>* rows) {
+    size_t n = rowCount(table, rows);
+    std::vector<uint32_t> sample;
+    if (maxTrainingRows > 0 && n > maxTrainingRows) {
+        sample.resize(maxTrainingRows);
+        for (size_t i = 0; i < maxTrainingRows; i++) {
+            size_t pick = i * n / maxTrainingRows;
+            sample[i] = rows ? (*rows)[pick] : (uint32_t)pick;
+        }
+        rows = &sample;
+    }
+    scaling.fit(table, rows);
+    training = scaling.apply(table, rows);
+}
+
+std::vector<float> KnnModel::score(const StudentTable& table, const std::vector<uint32_t>* rows,
+                                   int threads) const {
+    size_t n = rowCount(table, rows);
+    std::vector<float> result(n, 0.0f);
+    size_t neighbours = std::min((size_t)std::max(k, 1), training.rows);
+    if (neighbours == 0) return result;
+
+    const Kernels& kernel = kernels();
+    runSlices(n, sliceCount(n, threads, ParallelRows), [&](int, size_t begin, size_t end) {
+        std::vector<float> block((size_t)FeatureCount * BlockRows), distance(BlockRows);
+        std::vector<float> bestDistance(neighbours), bestLabel(neighbours);
+        for (size_t b = begin; b < end; b += BlockRows) {
+            size_t count = std::min(BlockRows, end - b);
+            fillBlock(scaling, table, rows, b, b + count, block.data(), BlockRows);
+            for (size_t i = 0; i < count; i++) {
+                float query[FeatureCount];
+                for (int f = 0; f < FeatureCount; f++) query[f] = block[(size_t)f * BlockRows + i];
+
+                // Insertion into a sorted list of the nearest so far; after the first few blocks
+                // almost every distance fails the first comparison
+                size_t filled = 0;
+                for (size_t t = 0; t < training.rows; t += BlockRows) {
+                    size_t tn = std::min(BlockRows, training.rows - t);
+                    const float* x[FeatureCount];
+                    for (int f = 0; f < FeatureCount; f++) x[f] = training.column(f) + t;
+                    kernel.distances(x, tn, query, distance.data());
+                    for (size_t j = 0; j < tn; j++) {
+                        float d = distance[j];
+                        if (filled == neighbours && d >= bestDistance[neighbours - 1]) continue;
+                        size_t slot = filled < neighbours ? filled++ : neighbours - 1;
+                        while (slot > 0 && bestDistance[slot - 1] > d) {
+                            bestDistance[slot] = bestDistance[slot - 1];
+                            bestLabel[slot] = bestLabel[slot - 1];
+                            slot--;
+                        }
+                        bestDistance[slot] = d;
+                        bestLabel[slot] = training.labels[t + j];
+                    }
+                }
+                float placed = 0;
+                for (size_t j = 0; j < neighbours; j++) placed += bestLabel[j];
+                result[b + i] = placed / (float)neighbours;
+            }
+        }
+    });
+    return result;
+}
+
+// ---------------------------------------------------------------- Cross-validation
+
+CrossValidation crossValidate(const StudentTable& table, ModelKind kind, size_t folds, int k, int threads) {
+    CrossValidation result;
+    size_t n = table.size();
+    result.rows = n;
+    if (n < 2) return result;
+    folds = std::min(std::max(folds, (size_t)2), n);
+    result.folds = folds;
+
+    size_t placed = 0;
+    for (size_t i = 0; i < n; i++) placed += table.placement[i];
+    result.baseline = (double)std::max(placed, n - placed) / (double)n;
+
+    size_t correct = 0;
+    std::vector<uint32_t> trainRows, testRows;
+    for (size_t fold = 0; fold < folds; fold++) {
+        trainRows.clear();
+        testRows.clear();
+        for (size_t i = 0; i < n; i++) (i % folds == fold ? testRows : trainRows).push_back((uint32_t)i);
+
+        std::vector<float> scores;
+        if (kind == ModelKind::Logistic) {
+            LogisticModel model;
+            LogisticOptions options;
+            options.threads = threads;
+            model.train(table, &trainRows, options);
+            scores = model.score(table, &testRows, threads);
+        } else {
+            KnnModel model;
+            model.k = k;
+            model.train(table, &trainRows);
+            scores = model.score(table, &testRows, threads);
+        }
+        for (size_t i = 0; i < testRows.size(); i++) {
+            correct += (scores[i] >= 0.5f) == (table.placement[testRows[i]] != 0);
+        }
+    }
+    result.accuracy = (double)correct / (double)n;
+    return result;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "studenttable.h"
+
+/*
+This header file defines placement prediction models trained on a
+StudentTable: logistic regression and k-nearest neighbours.
+
+Both models use every numeric and Yes/No column except Placement, which
+is the label. Each feature is standardized to zero mean and unit
+variance (fitted on the training rows only) and stored as its own float
+column. The heavy loops have AVX-512 and AVX2 kernels chosen at run
+time, plus a scalar fallback: logits and gradients for logistic
+regression, distances for kNN. Batch scoring splits the rows across
+threads.
+
+Row lists are optional everywhere: nullptr means every row of the table.
+*/
+
+const int FeatureCount = 8; // IQ .. Projects_Completed; Placement is the label
+
+// Standardized features of a set of rows
+struct FeatureMatrix {
+    size_t rows = 0;
+    std::vector<float> values;  // Feature f of row i is values[f * rows + i]
+    std::vector<float> labels;  // Placement of each row, 1 or 0
+
+    const float* column(int feature) const;
+};
+
+// Per-feature mean and 1 / standard deviation
+struct FeatureScaling {
+    float mean[FeatureCount] = {};
+    float inverseStd[FeatureCount] = {};
+
+    void fit(const StudentTable& table, const std::vector<uint32_t>* rows);
+    FeatureMatrix apply(const StudentTable& table, const std::vector<uint32_t>* rows) const;
+};
+
+struct LogisticOptions {
+    int epochs = 300;            // Full-batch gradient descent steps (fewer if it converges)
+    float learningRate = 0.5f;
+    float l2 = 1e-4f;            // Weight decay, keeps tiny training sets from diverging
+    int threads = 0;             // 0 uses every hardware thread
+};
+
+class LogisticModel {
+public:
+    FeatureScaling scaling;
+    float weights[FeatureCount] = {}; // Per standardized feature
+    float bias = 0;
+
+    void train(const StudentTable& table, const std::vector<uint32_t>* rows = nullptr,
+               const LogisticOptions& options = LogisticOptions());
+
+    // Placement probability of each row
+    std::vector<float> score(const StudentTable& table, const std::vector<uint32_t>* rows = nullptr,
+                             int threads = 0) const;
+};
+
+class KnnModel {
+public:
+    int k = 5;
+    size_t maxTrainingRows = 20000; // Larger training sets keep an evenly spaced sample
+    FeatureScaling scaling;
+    FeatureMatrix training;
+
+    void train(const StudentTable& table, const std::vector<uint32_t>* rows = nullptr);
+
+    // Fraction of each row's k nearest training rows that were placed
+    std::vector<float> score(const StudentTable& table, const std::vector<uint32_t>* rows = nullptr,
+                             int threads = 0) const;
+};
+
+enum class ModelKind { Logistic, Knn };
+
+struct CrossValidation {
+    size_t rows = 0;
+    size_t folds = 0;
+    double accuracy = 0;  // Held-out predictions (probability >= 0.5) that matched Placement
+    double baseline = 0;  // Accuracy of always predicting the majority class
+};
+
+// k-fold cross-validation: row i is held out in fold i % folds (folds is capped at the row count,
+// so folds >= rows is leave-one-out). k is only used by kNN.
+CrossValidation crossValidate(const StudentTable& table, ModelKind kind, size_t folds, int k = 5,
+                              int threads = 0);
+
+// Kernel set in use: "AVX-512", "AVX2" or "scalar"
+const char* modelKernelName();
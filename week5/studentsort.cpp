@@ -0,0 +1,413 @@
+#include "studentsort.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <queue>
+#include "../common/cpu.h"
+
+/*
+This source file implements the radix sort and top-N ranking declared
+in studentsort.h.
+*/
+
+namespace {
+
+const int DigitBits = 11;
+const size_t Buckets = (size_t)1 << DigitBits;
+const size_t BlockRows = 1024;
+const size_t SmallSort = 2048;   // Fewer rows than this use std::stable_sort
+const size_t ParallelKeys = 65536; // Fewer keys per thread sort on one thread
+
+// Where one sort key lives in the packed words
+struct KeySlot {
+    StudentColumn column;
+    bool descending;
+    uint64_t low;     // Smallest encoded value in the column
+    uint64_t range;   // Largest minus smallest encoded value
+    double scale;     // Doubles with few decimals are keyed as integers (value * scale); 0 otherwise
+    int word;         // Word index; higher words are more significant
+    int shift;        // Bit position inside the word
+};
+
+struct KeyPlan {
+    std::vector<KeySlot> slots;
+    int words = 0;
+    int topBits = 0;  // Bits used in the most significant word
+};
+
+// A candidate row for top-N with its packed key
+struct Ranked {
+    uint64_t key[MaxSortKeys];
+    uint32_t row;
+};
+
+}
+
+// Order-preserving unsigned encodings of the column types
+static uint64_t orderBits(int32_t x) {
+    return (uint64_t)((uint32_t)x ^ 0x80000000u);
+}
+
+static uint64_t orderBits(uint8_t x) {
+    return x;
+}
+
+static uint64_t orderBits(double x) {
+    x += 0.0;  // -0.0 becomes 0.0 so both zeros compare equal
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof bits);
+    return (bits >> 63) ? ~bits : bits | (1ull << 63); // NaN sorts after +infinity
+}
+
+// Doubles that all have at most a few decimals (CGPA, semester results) are sorted as
+// fixed-point integers, which needs ~10 key bits instead of ~53. Adding and subtracting
+// 1.5 * 2^52 rounds to the nearest integer without a libm call (|t| < 2^51).
+static double roundFixed(double t) {
+    const double magic = 6755399441055744.0;
+    return (t + magic) - magic;
+}
+
+static uint64_t fixedBits(double x, double scale) {
+    return (uint64_t)(long long)roundFixed(x * scale) ^ (1ull << 63);
+}
+
+// Smallest power of ten that turns every value into an exact integer, or 0 if none up to 10^4 does
+static double decimalScale(const Column<double>& column) {
+    for (double scale = 1; scale <= 10000; scale *= 10) {
+        size_t misses = 0;
+        for (size_t b = 0; b < column.size() && misses == 0; b += BlockRows) {
+            size_t end = std::min(column.size(), b + BlockRows);
+            for (size_t i = b; i < end; i++) {
+                double t = column[i] * scale;
+                misses += !(std::fabs(t) < 1e15) || roundFixed(t) / scale != column[i]; // NaN/inf miss too
+            }
+        }
+        if (misses == 0) return scale;
+    }
+    return 0;
+}
+
+template <typename T>
+static void columnBounds(const Column<T>& column, uint64_t& low, uint64_t& high) {
+    low = ~0ull;
+    high = 0;
+    for (const T& x : column) {
+        uint64_t e = orderBits(x);
+        low = e < low ? e : low;
+        high = e > high ? e : high;
+    }
+}
+
+template <typename T>
+static void encodeRows(const Column<T>& column, const uint32_t* rows, size_t n, uint64_t* out) {
+    for (size_t i = 0; i < n; i++) out[i] = orderBits(column[rows[i]]);
+}
+
+static void encodeRows(const Column<double>& column, double scale, const uint32_t* rows, size_t n,
+                       uint64_t* out) {
+    if (scale == 0) {
+        encodeRows(column, rows, n, out);
+        return;
+    }
+    for (size_t i = 0; i < n; i++) out[i] = fixedBits(column[rows[i]], scale);
+}
+
+// Dispatches fn(columnVector) for a column
+template <typename Fn>
+static void withColumn(const StudentTable& t, StudentColumn column, Fn fn) {
+    switch (column) {
+    case StudentColumn::IQ:                   fn(t.iq); break;
+    case StudentColumn::PrevSemResult:        fn(t.prev_sem_result); break;
+    case StudentColumn::CGPA:                 fn(t.cgpa); break;
+    case StudentColumn::AcademicPerformance:  fn(t.academic_performance); break;
+    case StudentColumn::InternshipExperience: fn(t.internship_experience); break;
+    case StudentColumn::ExtraCurricularScore: fn(t.extra_curricular_score); break;
+    case StudentColumn::CommunicationSkills:  fn(t.communication_skills); break;
+    case StudentColumn::ProjectsCompleted:    fn(t.projects_completed); break;
+    case StudentColumn::Placement:            fn(t.placement); break;
+    }
+}
+
+// Sizes every key to its column's range and packs them, the last key in the lowest bits
+static KeyPlan planKeys(const StudentTable& table, const std::vector<SortKey>& keys) {
+    KeyPlan plan;
+    plan.slots.resize(keys.size());
+    int word = 0, used = 0;
+    for (size_t k = keys.size(); k-- > 0;) {
+        KeySlot& slot = plan.slots[k];
+        slot.column = keys[k].column;
+        slot.descending = keys[k].descending;
+        slot.scale = 0;
+        uint64_t high = 0;
+        if (slot.column == StudentColumn::PrevSemResult || slot.column == StudentColumn::CGPA) {
+            const Column<double>& column =
+                slot.column == StudentColumn::CGPA ? table.cgpa : table.prev_sem_result;
+            slot.scale = decimalScale(column);
+        }
+        if (slot.scale != 0) {
+            const Column<double>& column =
+                slot.column == StudentColumn::CGPA ? table.cgpa : table.prev_sem_result;
+            auto bounds = std::minmax_element(column.begin(), column.end());
+            slot.low = fixedBits(*bounds.first, slot.scale);
+            high = fixedBits(*bounds.second, slot.scale);
+        } else {
+            withColumn(table, slot.column, [&](const auto& column) { columnBounds(column, slot.low, high); });
+        }
+        if (high < slot.low) slot.low = high = 0; // Empty table
+        slot.range = high - slot.low;
+
+        int bits = 0;
+        while (bits < 64 && (slot.range >> bits) != 0) bits++;
+        if (used + bits > 64) {
+            word++;
+            used = 0;
+        }
+        slot.word = word;
+        slot.shift = used;
+        used += bits;
+    }
+    plan.words = word + 1;
+    plan.topBits = used;
+    return plan;
+}
+
+// Packed key words for rows[0..n); out[w] receives word w for each row
+static void packKeys(const StudentTable& table, const KeyPlan& plan, const uint32_t* rows, size_t n,
+                     uint64_t* const* out, uint64_t* scratch) {
+    for (int w = 0; w < plan.words; w++) std::fill(out[w], out[w] + n, 0);
+    for (const KeySlot& slot : plan.slots) {
+        if (slot.scale != 0) {
+            const Column<double>& column =
+                slot.column == StudentColumn::CGPA ? table.cgpa : table.prev_sem_result;
+            encodeRows(column, slot.scale, rows, n, scratch);
+        } else {
+            withColumn(table, slot.column, [&](const auto& column) { encodeRows(column, rows, n, scratch); });
+        }
+        uint64_t* word = out[slot.word];
+        for (size_t i = 0; i < n; i++) {
+            uint64_t v = scratch[i] - slot.low;
+            if (slot.descending) v = slot.range - v;
+            word[i] |= v << slot.shift;
+        }
+    }
+}
+
+// Stable LSD radix sort of keys on bits [fromBit, 64). When order is given, order[i]
+// travels with keys[i]; otherwise only keys move.
+static void radixPasses(std::vector<uint64_t>& keys, std::vector<uint32_t>* order, int fromBit, int threads) {
+    size_t n = keys.size();
+    uint64_t anyOne = 0, allOne = ~0ull;
+    for (uint64_t k : keys) {
+        anyOne |= k;
+        allOne &= k;
+    }
+    uint64_t varying = (anyOne ^ allOne) >> fromBit << fromBit;  // Key bits that differ somewhere
+
+    std::vector<uint64_t> keysOut(n);
+    std::vector<uint32_t> orderOut(order ? n : 0);
+    std::vector<size_t> counts((size_t)threads * Buckets);
+    for (int shift = fromBit; shift < 64; shift += DigitBits) {
+        if (((varying >> shift) & (Buckets - 1)) == 0) continue; // Every row has the same digit
+
+        const uint64_t* in = keys.data();
+        std::fill(counts.begin(), counts.end(), 0);
+        runSlices(n, threads, [&, in, shift](int slice, size_t begin, size_t end) {
+            size_t* count = counts.data() + slice * Buckets;
+            for (size_t i = begin; i < end; i++) count[(in[i] >> shift) & (Buckets - 1)]++;
+        });
+
+        // Bucket-major, slice-minor offsets keep equal digits in their current order
+        size_t offset = 0;
+        for (size_t b = 0; b < Buckets; b++) {
+            for (int t = 0; t < threads; t++) {
+                size_t c = counts[t * Buckets + b];
+                counts[t * Buckets + b] = offset;
+                offset += c;
+            }
+        }
+
+        const uint32_t* inOrder = order ? order->data() : nullptr;
+        uint64_t* out = keysOut.data();
+        uint32_t* outOrder = orderOut.data();
+        runSlices(n, threads, [&, in, inOrder, out, outOrder, shift](int slice, size_t begin, size_t end) {
+            uint32_t next[Buckets]; // Local copy: stores to out cannot alias it
+            for (size_t b = 0; b < Buckets; b++) next[b] = (uint32_t)counts[slice * Buckets + b];
+            if (inOrder) {
+                for (size_t i = begin; i < end; i++) {
+                    uint64_t key = in[i];
+                    uint32_t dst = next[(key >> shift) & (Buckets - 1)]++;
+                    out[dst] = key;
+                    outOrder[dst] = inOrder[i];
+                }
+            } else {
+                for (size_t i = begin; i < end; i++) {
+                    uint64_t key = in[i];
+                    out[next[(key >> shift) & (Buckets - 1)]++] = key;
+                }
+            }
+        });
+        keys.swap(keysOut);
+        if (order) order->swap(orderOut);
+    }
+}
+
+static std::vector<uint32_t> candidateRows(const StudentTable& table, const Selection* filter) {
+    if (filter) return filter->toRows();
+    std::vector<uint32_t> rows(table.size());
+    std::iota(rows.begin(), rows.end(), 0u);
+    return rows;
+}
+
+std::vector<uint32_t> sortStudents(const StudentTable& table, const std::vector<SortKey>& keys,
+                                   const Selection* filter, int threads) {
+    std::vector<uint32_t> rows = candidateRows(table, filter);
+    if (keys.empty() || rows.size() < 2) return rows;
+    size_t n = rows.size();
+    threads = sliceCount(n, threads, ParallelKeys);
+
+    KeyPlan plan = planKeys(table, keys);
+    std::vector<std::vector<uint64_t>> words(plan.words, std::vector<uint64_t>(n));
+    runSlices(n, threads, [&](int, size_t begin, size_t end) {
+        uint64_t scratch[BlockRows];
+        std::vector<uint64_t*> out(plan.words);
+        for (size_t b = begin; b < end; b += BlockRows) {
+            for (int w = 0; w < plan.words; w++) out[w] = words[w].data() + b;
+            packKeys(table, plan, rows.data() + b, std::min(end - b, BlockRows), out.data(), scratch);
+        }
+    });
+
+    int positionBits = 0;
+    while (((n - 1) >> positionBits) != 0) positionBits++;
+    std::vector<uint32_t> result(n);
+
+    if (plan.words == 1 && plan.topBits + positionBits <= 64 && n >= SmallSort) {
+        // Common case: the row position fits below the key, so only one array moves and
+        // ties stay in position order without an extra pass
+        std::vector<uint64_t>& packed = words[0];
+        for (size_t i = 0; i < n; i++) packed[i] = packed[i] << positionBits | i;
+        radixPasses(packed, nullptr, positionBits, threads);
+        uint64_t mask = (1ull << positionBits) - 1;
+        for (size_t i = 0; i < n; i++) result[i] = rows[packed[i] & mask];
+        return result;
+    }
+
+    std::vector<uint32_t> order(n); // Positions into rows, permuted into sorted order
+    std::iota(order.begin(), order.end(), 0u);
+    if (n < SmallSort) {
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            for (int w = plan.words - 1; w >= 0; w--) {
+                if (words[w][a] != words[w][b]) return words[w][a] < words[w][b];
+            }
+            return false;
+        });
+    } else {
+        // Least significant word first; each pass is stable, so earlier words break ties
+        std::vector<uint64_t> current = std::move(words[0]);
+        radixPasses(current, &order, 0, threads);
+        for (int w = 1; w < plan.words; w++) {
+            for (size_t i = 0; i < n; i++) current[i] = words[w][order[i]];
+            radixPasses(current, &order, 0, threads);
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) result[i] = rows[order[i]];
+    return result;
+}
+
+std::vector<uint32_t> topStudents(const StudentTable& table, const std::vector<SortKey>& keys, size_t n,
+                                  const Selection* filter, int threads) {
+    if (keys.empty() || n == 0) {
+        std::vector<uint32_t> rows = candidateRows(table, filter);
+        if (rows.size() > n) rows.resize(n);
+        return rows;
+    }
+    if (keys.size() > (size_t)MaxSortKeys) {
+        std::vector<uint32_t> rows = sortStudents(table, keys, filter, threads);
+        if (rows.size() > n) rows.resize(n);
+        return rows;
+    }
+    std::vector<uint32_t> selected;  // Only materialized for a filter; otherwise rows are 0..size-1
+    if (filter) selected = filter->toRows();
+    size_t total = filter ? selected.size() : table.size();
+    threads = sliceCount(total, threads, ParallelKeys);
+
+    // One full-width word per key: no column scans up front, which would cost more than the heap
+    KeyPlan plan;
+    plan.words = (int)keys.size();
+    for (size_t k = 0; k < keys.size(); k++) {
+        KeySlot slot = {keys[k].column, keys[k].descending, 0, ~0ull, 0, (int)(keys.size() - 1 - k), 0};
+        plan.slots.push_back(slot);
+    }
+    int words = plan.words;
+
+    // Ranks by key words (most significant first), then by row so ties match sortStudents
+    auto before = [words](const Ranked& a, const Ranked& b) {
+        for (int w = words - 1; w >= 0; w--) {
+            if (a.key[w] != b.key[w]) return a.key[w] < b.key[w];
+        }
+        return a.row < b.row;
+    };
+    typedef std::priority_queue<Ranked, std::vector<Ranked>, decltype(before)> Heap; // Worst kept row on top
+
+    std::vector<Heap> heaps(threads, Heap(before));
+    runSlices(total, threads, [&](int slice, size_t begin, size_t end) {
+        Heap& heap = heaps[slice];
+        uint64_t packed[MaxSortKeys][BlockRows];
+        uint64_t scratch[BlockRows];
+        uint64_t* out[MaxSortKeys] = {packed[0], packed[1], packed[2], packed[3]};
+        uint32_t blockRows[BlockRows];
+        for (size_t b = begin; b < end; b += BlockRows) {
+            size_t count = std::min(end - b, BlockRows);
+            const uint32_t* rows = blockRows;
+            if (filter) rows = selected.data() + b;
+            else std::iota(blockRows, blockRows + count, (uint32_t)b);
+            packKeys(table, plan, rows, count, out, scratch);
+            for (size_t i = 0; i < count; i++) {
+                Ranked candidate;
+                for (int w = 0; w < words; w++) candidate.key[w] = packed[w][i];
+                candidate.row = rows[i];
+                if (heap.size() < n) {
+                    heap.push(candidate);
+                } else if (before(candidate, heap.top())) {
+                    heap.pop();
+                    heap.push(candidate);
+                }
+            }
+        }
+    });
+
+    std::vector<Ranked> best;
+    for (Heap& heap : heaps) {
+        for (; !heap.empty(); heap.pop()) best.push_back(heap.top());
+    }
+    std::sort(best.begin(), best.end(), before);
+    if (best.size() > n) best.resize(n);
+
+    std::vector<uint32_t> result;
+    result.reserve(best.size());
+    for (const Ranked& r : best) result.push_back(r.row);
+    return result;
+}
+
+bool parseSortKeys(const std::string& text, std::vector<SortKey>& keys) {
+    keys.clear();
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t comma = text.find(',', start);
+        if (comma == std::string::npos) comma = text.size();
+        std::string part = text.substr(start, comma - start);
+        size_t colon = part.find(':');
+
+        SortKey key;
+        if (!studentColumnByName(part.substr(0, colon), key.column)) return false;
+        if (colon != std::string::npos) {
+            std::string direction = part.substr(colon + 1);
+            if (direction == "desc") key.descending = true;
+            else if (direction != "asc") return false;
+        }
+        keys.push_back(key);
+        start = comma + 1;
+    }
+    return !keys.empty() && keys.size() <= (size_t)MaxSortKeys;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "studentfilter.h"
+#include "studenttable.h"
+
+/*
+This header file defines multi-key sorting and top-N ranking over a
+StudentTable. Nothing moves: results are row numbers in ranked order,
+so a caller displays students with table.student(row).
+
+Each sort key is mapped to an unsigned integer with the same order
+(descending keys are flipped), shifted down to its column's range and
+packed with the other keys into as few 64-bit words as possible. A
+stable parallel LSD radix sort then orders the rows by those words,
+skipping digits that are the same in every row. Top-N keeps a bounded
+heap per thread instead of sorting everything.
+*/
+
+const int MaxSortKeys = 4;
+
+struct SortKey {
+    StudentColumn column;
+    bool descending = false;
+};
+
+// Rows sorted by keys; ties keep table order. filter restricts the rows when set,
+// threads = 0 uses every hardware thread.
+std::vector<uint32_t> sortStudents(const StudentTable& table, const std::vector<SortKey>& keys,
+                                   const Selection* filter = nullptr, int threads = 0);
+
+// The first n rows sortStudents would return, without sorting the rest
+std::vector<uint32_t> topStudents(const StudentTable& table, const std::vector<SortKey>& keys, size_t n,
+                                  const Selection* filter = nullptr, int threads = 0);
+
+// Parses "cgpa:desc,iq:desc,projects_completed" (ascending unless :desc). False on a bad key.
+bool parseSortKeys(const std::string& text, std::vector<SortKey>& keys);
@@ -0,0 +1,220 @@
+#include "studenttable.h"
+#include <cstring>
+#include <thread>
+#include "../common/cpu.h"
+#include "../common/csvschema.h"
+#include "../common/mappedfile.h"
+
+/*
+This source file implements StudentTable and the parallel CSV loader
+declared in studenttable.h.
+*/
+
+StudentTable::StudentTable() {
+    id_offsets.push_back(0); // Offsets always hold size() + 1 entries
+}
+
+size_t StudentTable::size() const {
+    return iq.size();
+}
+
+std::string_view StudentTable::collegeId(size_t row) const {
+    return std::string_view(id_arena.data() + id_offsets[row], id_offsets[row + 1] - id_offsets[row]);
+}
+
+Student StudentTable::student(size_t row) const {
+    return Student(std::string(collegeId(row)), iq[row], prev_sem_result[row], cgpa[row],
+                   academic_performance[row], internship_experience[row] != 0,
+                   extra_curricular_score[row], communication_skills[row],
+                   projects_completed[row], placement[row] != 0);
+}
+
+void StudentTable::reserve(size_t rows, size_t idBytes) {
+    iq.reserve(rows);
+    prev_sem_result.reserve(rows);
+    cgpa.reserve(rows);
+    academic_performance.reserve(rows);
+    internship_experience.reserve(rows);
+    extra_curricular_score.reserve(rows);
+    communication_skills.reserve(rows);
+    projects_completed.reserve(rows);
+    placement.reserve(rows);
+    id_arena.reserve(idBytes);
+    id_offsets.reserve(rows + 1);
+}
+
+void StudentTable::append(const StudentTable& other) {
+    iq.append(other.iq.begin(), other.iq.end());
+    prev_sem_result.append(other.prev_sem_result.begin(), other.prev_sem_result.end());
+    cgpa.append(other.cgpa.begin(), other.cgpa.end());
+    academic_performance.append(other.academic_performance.begin(), other.academic_performance.end());
+    internship_experience.append(other.internship_experience.begin(), other.internship_experience.end());
+    extra_curricular_score.append(other.extra_curricular_score.begin(), other.extra_curricular_score.end());
+    communication_skills.append(other.communication_skills.begin(), other.communication_skills.end());
+    projects_completed.append(other.projects_completed.begin(), other.projects_completed.end());
+    placement.append(other.placement.begin(), other.placement.end());
+
+    // Shift the other table's offsets past our arena
+    uint32_t base = (uint32_t)id_arena.size();
+    id_arena.append(other.id_arena.begin(), other.id_arena.end());
+    for (size_t i = 1; i < other.id_offsets.size(); i++) {
+        id_offsets.push_back(base + other.id_offsets[i]);
+    }
+}
+
+void StudentTable::clear() {
+    *this = StudentTable();
+}
+
+// One CSV data row as parsed; the College ID points into the file
+struct StudentCsvRow {
+    std::string_view id;
+    int32_t iq;
+    double prev_sem_result;
+    double cgpa;
+    int32_t academic_performance;
+    uint8_t internship_experience;
+    int32_t extra_curricular_score;
+    int32_t communication_skills;
+    int32_t projects_completed;
+    uint8_t placement;
+};
+
+static const CsvSchema studentSchema(
+    CsvField<&StudentCsvRow::id>("College_ID"),
+    CsvField<&StudentCsvRow::iq>("IQ"),
+    CsvField<&StudentCsvRow::prev_sem_result>("Prev_Sem_Result"),
+    CsvField<&StudentCsvRow::cgpa>("CGPA"),
+    CsvField<&StudentCsvRow::academic_performance>("Academic_Performance"),
+    CsvField<&StudentCsvRow::internship_experience, CsvYesNo>("Internship_Experience"),
+    CsvField<&StudentCsvRow::extra_curricular_score>("Extra_Curricular_Score"),
+    CsvField<&StudentCsvRow::communication_skills>("Communication_Skills"),
+    CsvField<&StudentCsvRow::projects_completed>("Projects_Completed"),
+    CsvField<&StudentCsvRow::placement, CsvYesNo>("Placement"));
+
+bool parseStudentRow(const char* begin, const char* end, StudentTable& table) {
+    StudentCsvRow row;
+    if (studentSchema.parse(begin, end, row) >= 0) return false;
+
+    table.id_arena.append(row.id.begin(), row.id.end());
+    table.id_offsets.push_back((uint32_t)table.id_arena.size());
+    table.iq.push_back(row.iq);
+    table.prev_sem_result.push_back(row.prev_sem_result);
+    table.cgpa.push_back(row.cgpa);
+    table.academic_performance.push_back(row.academic_performance);
+    table.internship_experience.push_back(row.internship_experience);
+    table.extra_curricular_score.push_back(row.extra_curricular_score);
+    table.communication_skills.push_back(row.communication_skills);
+    table.projects_completed.push_back(row.projects_completed);
+    table.placement.push_back(row.placement);
+    return true;
+}
+
+// Parses every complete line in [begin, end) into table; returns the number of bad rows
+static size_t parseChunk(const char* begin, const char* end, StudentTable& table) {
+    size_t bad = 0;
+    // Rough row estimate (~40 bytes per row) so the columns rarely reallocate
+    table.reserve((size_t)(end - begin) / 40 + 16, (size_t)(end - begin) / 5);
+    const char* p = begin;
+    while (p < end) {
+        const char* nl = (const char*)std::memchr(p, '\n', (size_t)(end - p));
+        const char* lineEnd = nl ? nl : end;
+        if (lineEnd > p && !(lineEnd - p == 1 && *p == '\r')) {
+            if (!parseStudentRow(p, lineEnd, table)) bad++;
+        }
+        p = nl ? nl + 1 : end;
+    }
+    return bad;
+}
+
+const size_t ParallelBytes = 65536; // Less CSV per thread parses on one thread
+
+size_t parseStudentRows(const char* begin, const char* end, StudentTable& table, int threads) {
+    size_t bodySize = (size_t)(end - begin);
+    threads = sliceCount(bodySize, threads, ParallelBytes);
+    if (threads == 1) return parseChunk(begin, end, table);
+
+    // Split into roughly equal chunks, moving each boundary forward to a line start
+    std::vector<const char*> bounds(threads + 1);
+    bounds[0] = begin;
+    bounds[threads] = end;
+    for (int i = 1; i < threads; i++) {
+        const char* guess = begin + bodySize / threads * i;
+        if (guess < bounds[i - 1]) guess = bounds[i - 1];
+        const char* nl = (const char*)std::memchr(guess, '\n', (size_t)(end - guess));
+        bounds[i] = nl ? nl + 1 : end;
+    }
+
+    std::vector<StudentTable> parts(threads);
+    std::vector<size_t> bad(threads, 0);
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; i++) {
+        workers.emplace_back([&, i]() { bad[i] = parseChunk(bounds[i], bounds[i + 1], parts[i]); });
+    }
+    bad[0] = parseChunk(bounds[0], bounds[1], parts[0]); // This thread takes the first chunk
+    for (std::thread& t : workers) t.join();
+
+    // Concatenate the chunks in file order
+    size_t rows = table.size(), idBytes = table.id_arena.size(), badRows = 0;
+    for (int i = 0; i < threads; i++) {
+        rows += parts[i].size();
+        idBytes += parts[i].id_arena.size();
+        badRows += bad[i];
+    }
+    if (table.size() == 0) {
+        table = std::move(parts[0]);
+        table.reserve(rows, idBytes);
+        for (int i = 1; i < threads; i++) table.append(parts[i]);
+    } else {
+        table.reserve(rows, idBytes);
+        for (int i = 0; i < threads; i++) table.append(parts[i]);
+    }
+    return badRows;
+}
+
+bool loadStudentTable(const std::string& path, StudentTable& table, LoadStats& stats, int threads) {
+    MappedFile file;
+    if (!file.open(path)) return false;
+    stats = LoadStats();
+    stats.bytes = file.size();
+    table.clear();
+    if (file.size() == 0) return true;
+
+    const char* data = file.data();
+    const char* end = data + file.size();
+    const char* body = (const char*)std::memchr(data, '\n', file.size()); // Skip header row
+    if (!body) return true;
+    studentSchema.checkHeader(data, body, stats.headerError); // Columns are read by position either way
+
+    stats.badRows = parseStudentRows(body + 1, end, table, threads);
+    stats.rows = table.size();
+    return true;
+}
+
+void writeStudentReport(ReportWriter& out, ReportFormat format, const StudentTable& table,
+                        const std::vector<uint32_t>* rows) {
+    std::vector<ReportColumn> columns;
+    for (size_t c = 0; c < studentSchema.FieldCount; c++) {
+        bool yesNo = c == 5 || c == 9;
+        columns.push_back({studentSchema.name(c), 0, c > 0 && !yesNo}); // Numbers align right in text reports
+    }
+    columns[0].width = 10; // Room for typical College IDs
+    columns[1].width = 3;  // IQ
+    out.begin(format, columns);
+
+    size_t n = rows ? rows->size() : table.size();
+    for (size_t i = 0; i < n; i++) {
+        size_t r = rows ? (*rows)[i] : i;
+        out.text(table.collegeId(r));
+        out.integer(table.iq[r]);
+        out.number(table.prev_sem_result[r]);
+        out.number(table.cgpa[r]);
+        out.integer(table.academic_performance[r]);
+        out.yesNo(table.internship_experience[r]);
+        out.integer(table.extra_curricular_score[r]);
+        out.integer(table.communication_skills[r]);
+        out.integer(table.projects_completed[r]);
+        out.yesNo(table.placement[r]);
+        out.endRow();
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "student.h"
+#include "../common/column.h"
+#include "../common/reportwriter.h"
+
+class MappedFile;
+
+/*
+This header file defines the StudentTable class and the CSV loader.
+StudentTable stores the placement dataset column by column (struct of
+arrays): one contiguous column per Student field, with all College IDs
+packed into a single character arena. Analytics can then scan just the
+columns they need instead of walking Student objects. A table reloaded
+from a cache file (studentcache.h) views the mapped file instead of
+owning its columns; see Column.
+*/
+
+class StudentTable {
+public:
+    // One entry per row in every column
+    Column<int32_t> iq;
+    Column<double> prev_sem_result;
+    Column<double> cgpa;
+    Column<int32_t> academic_performance;
+    Column<uint8_t> internship_experience; // 1 = Yes, 0 = No
+    Column<int32_t> extra_curricular_score;
+    Column<int32_t> communication_skills;
+    Column<int32_t> projects_completed;
+    Column<uint8_t> placement;             // 1 = Yes, 0 = No
+
+    // College IDs: row i is id_arena[id_offsets[i] .. id_offsets[i + 1])
+    Column<char> id_arena;
+    Column<uint32_t> id_offsets;
+
+    std::shared_ptr<MappedFile> backing; // Cache file the columns view (nullptr when they own their values)
+
+    StudentTable();
+
+    size_t size() const;                         // Number of rows
+    std::string_view collegeId(size_t row) const; // College ID of a row (points into the arena)
+    Student student(size_t row) const;           // Builds a Student object for one row
+
+    void reserve(size_t rows, size_t idBytes);   // Pre-allocates every column
+    void append(const StudentTable& other);      // Copies all rows of other onto the end
+    void clear();                                // Removes every row
+};
+
+// Result of loading a CSV file into a StudentTable
+struct LoadStats {
+    size_t rows = 0;      // Rows loaded
+    size_t badRows = 0;   // Rows skipped because a field was missing or malformed
+    size_t bytes = 0;     // Size of the file
+    std::string headerError; // Why the header row differs from the expected columns (empty if it matches)
+};
+
+// Parses one CSV data row and appends it to the table; false if the row is malformed
+bool parseStudentRow(const char* begin, const char* end, StudentTable& table);
+
+// Parses every line in [begin, end) (no header) and appends the rows to table, splitting large
+// inputs across threads (0 = every hardware thread). Returns the number of malformed rows skipped.
+size_t parseStudentRows(const char* begin, const char* end, StudentTable& table, int threads = 0);
+
+// Memory-maps a placement CSV (with header row) and parses it in parallel chunks.
+// threads = 0 uses every hardware thread. Returns false if the file cannot be opened.
+bool loadStudentTable(const std::string& path, StudentTable& table, LoadStats& stats, int threads = 0);
+
+// Writes the given rows (every row if nullptr) as a report with the CSV column names
+void writeStudentReport(ReportWriter& out, ReportFormat format, const StudentTable& table,
+                        const std::vector<uint32_t>* rows = nullptr);